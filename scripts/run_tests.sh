@@ -1,7 +1,10 @@
 #!/bin/bash
 
 # N64 Emulator Test Runner
-# Runs each test ROM for 5 seconds
+# Runs each test ROM for 5 seconds. A ROM with a <name>.hash file next to it
+# (recorded with VI_HASH) is instead run headless up to the last frame the
+# file lists and its frame hashes are compared, replaying <name>.input
+# (recorded with INPUT_RECORD) when present.
 
 EMULATOR="./n64"
 TEST_DIR="tests/roms/peterlemon/CPUTest/CPU"  # Only CPU tests
@@ -24,6 +27,22 @@ for ROM in $ROMS; do
     TEST_NAME=$(basename "$ROM" .N64)
     
     printf "[%3d/%3d] %-40s " "$COUNT" "$TOTAL" "$TEST_NAME"
+
+    EXPECTED="${ROM%.N64}.hash"
+    if [ -f "$EXPECTED" ]; then
+        FRAMES=$(( $(tail -n 1 "$EXPECTED" | cut -d' ' -f1) + 1 ))
+        ACTUAL=$(mktemp)
+        INPUT="${ROM%.N64}.input"
+        [ -f "$INPUT" ] || INPUT=""
+        INPUT_REPLAY="$INPUT" VI_HEADLESS=1 VI_HASH="$ACTUAL" VI_EXIT_FRAME="$FRAMES" "$EMULATOR" "$ROM" 2>/dev/null
+        if cmp -s "$EXPECTED" "$ACTUAL"; then
+            echo "PASS"
+        else
+            echo "FAIL (frame hashes differ)"
+        fi
+        rm -f "$ACTUAL"
+        continue
+    fi
     
     # Run in background, kill after timeout
     "$EMULATOR" "$ROM" 2>/dev/null &
@@ -342,4 +342,69 @@ u64 CP0::get_exception_vector_address(ExceptionCode code, bool old_exl) const {
     return base + offset;
 }
 
+void CP0::save_state(StateWriter& writer) const
+{
+    writer.begin_chunk("CP0 ", 1);
+    writer.write(tlb_);
+    writer.write(index_);
+    writer.write(random_);
+    writer.write(entry_lo0_);
+    writer.write(entry_lo1_);
+    writer.write(context_);
+    writer.write(page_mask_);
+    writer.write(wired_);
+    writer.write(bad_vaddr_);
+    writer.write(count_);
+    writer.write(entry_hi_);
+    writer.write(compare_);
+    writer.write(status_);
+    writer.write(cause_);
+    writer.write(epc_);
+    writer.write(prid_);
+    writer.write(config_);
+    writer.write(ll_addr_);
+    writer.write(watch_lo_);
+    writer.write(watch_hi_);
+    writer.write(xcontext_);
+    writer.write(parity_error_);
+    writer.write(cache_error_);
+    writer.write(tag_lo_);
+    writer.write(tag_hi_);
+    writer.write(error_epc_);
+    writer.write(count_odd_);
+    writer.end_chunk();
+}
+
+void CP0::load_state(StateReader& reader)
+{
+    if (!reader.open_chunk("CP0 ", 1)) return;
+    reader.read(tlb_);
+    reader.read(index_);
+    reader.read(random_);
+    reader.read(entry_lo0_);
+    reader.read(entry_lo1_);
+    reader.read(context_);
+    reader.read(page_mask_);
+    reader.read(wired_);
+    reader.read(bad_vaddr_);
+    reader.read(count_);
+    reader.read(entry_hi_);
+    reader.read(compare_);
+    reader.read(status_);
+    reader.read(cause_);
+    reader.read(epc_);
+    reader.read(prid_);
+    reader.read(config_);
+    reader.read(ll_addr_);
+    reader.read(watch_lo_);
+    reader.read(watch_hi_);
+    reader.read(xcontext_);
+    reader.read(parity_error_);
+    reader.read(cache_error_);
+    reader.read(tag_lo_);
+    reader.read(tag_hi_);
+    reader.read(error_epc_);
+    reader.read(count_odd_);
+}
+
 } // namespace n64::cpu
@@ -2,6 +2,7 @@
 
 #include <array>
 #include "cp0_registers.hpp"
+#include "../utils/save_state.hpp"
 
 namespace n64::cpu {
 
@@ -43,6 +44,9 @@ public:
     void raise_address_exception(ExceptionCode code, u64 address);
     void set_mi_interrupt(bool active) { cause_.ip = set_bit(cause_.ip, 2, active); }
 
+    void save_state(StateWriter& writer) const;
+    void load_state(StateReader& reader);
+
 private:
     u32 tlb_lookup(u64 virtual_address, bool is_write);
     void raise_tlb_exception(ExceptionCode code, u64 virtual_address);
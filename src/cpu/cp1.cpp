@@ -100,4 +100,21 @@ bool CP1::get_condition_bit() const {
     return status_.condition;
 }
 
+void CP1::save_state(StateWriter& writer) const {
+    writer.begin_chunk("CP1 ", 1);
+    writer.write(fpr_);
+    writer.write(status_);
+    writer.write(revision_);
+    writer.write(fr_bit_);
+    writer.end_chunk();
+}
+
+void CP1::load_state(StateReader& reader) {
+    if (!reader.open_chunk("CP1 ", 1)) return;
+    reader.read(fpr_);
+    reader.read(status_);
+    reader.read(revision_);
+    reader.read(fr_bit_);
+}
+
 } // namespace n64::cpu
@@ -3,6 +3,7 @@
 #include <array>
 
 #include "../utils/types.hpp"
+#include "../utils/save_state.hpp"
 
 namespace n64::cpu {
 
@@ -92,6 +93,9 @@ public:
     void set_fr_bit(bool fr) { fr_bit_ = fr; }
     [[nodiscard]] bool get_fr_bit() const { return fr_bit_; }
 
+    void save_state(StateWriter& writer) const;
+    void load_state(StateReader& reader);
+
 private:
     // 32 64-bit registers (can be accessed as 32 singles or 16 doubles depending on FR bit)
     std::array<u64, 32> fpr_{};
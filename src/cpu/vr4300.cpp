@@ -276,6 +276,47 @@ template u8 VR4300::read_memory<u8>(u64 address);
 template u16 VR4300::read_memory<u16>(u64 address);
 template u32 VR4300::read_memory<u32>(u64 address);
 template u64 VR4300::read_memory<u64>(u64 address);
+void VR4300::save_state(StateWriter& writer) const
+{
+    writer.begin_chunk("CPU ", 1);
+    writer.write(gpr_);
+    writer.write(pc_);
+    writer.write(hi_);
+    writer.write(lo_);
+    writer.write(ll_bit_);
+    writer.write(branch_pending_);
+    writer.write(branch_target_);
+    writer.write(should_branch);
+    writer.write(interrupt_inhibit_);
+    writer.write(exception_pending_);
+    writer.end_chunk();
+
+    cp0_.save_state(writer);
+    cp1_.save_state(writer);
+}
+
+void VR4300::load_state(StateReader& reader)
+{
+    if (reader.open_chunk("CPU ", 1)) {
+        reader.read(gpr_);
+        reader.read(pc_);
+        reader.read(hi_);
+        reader.read(lo_);
+        reader.read(ll_bit_);
+        reader.read(branch_pending_);
+        reader.read(branch_target_);
+        reader.read(should_branch);
+        reader.read(interrupt_inhibit_);
+        reader.read(exception_pending_);
+    }
+
+    cp0_.load_state(reader);
+    cp1_.load_state(reader);
+
+    // Cached instructions belong to the old RDRAM contents
+    icache_invalidate_all();
+}
+
 template void VR4300::write_memory<u8>(u64 address, u8 value);
 template void VR4300::write_memory<u16>(u64 address, u16 value);
 template void VR4300::write_memory<u32>(u64 address, u32 value);
@@ -8,6 +8,7 @@
 #include "instruction_table.hpp"
 #include "cp0.hpp"
 #include "cp1.hpp"
+#include "../utils/save_state.hpp"
 
 namespace n64::cpu {
 
@@ -63,6 +64,10 @@ public:
     void icache_invalidate(u64 virtual_address);
     void icache_invalidate_all();
 
+    // Save states (also cover CP0 and CP1)
+    void save_state(StateWriter& writer) const;
+    void load_state(StateReader& reader);
+
 private:
     // Registers
     std::array<u64, 32> gpr_{};
@@ -1,4 +1,5 @@
 #include "ai.hpp"
+#include <algorithm>
 
 namespace n64::interfaces {
 
@@ -12,25 +13,10 @@ AI::AI(MI& mi, memory::RDRAM& rdram)
     , dacrate_{.raw = 0}
     , bitrate_{.raw = 0}
 {
-    SDL_Init(SDL_INIT_AUDIO);
-
-    SDL_AudioSpec spec;
-    spec.format = SDL_AUDIO_S16LE;
-    spec.channels = 2;
-    spec.freq = 44100;
-
-    audio_stream_ = SDL_OpenAudioDeviceStream(SDL_AUDIO_DEVICE_DEFAULT_PLAYBACK, &spec, nullptr, nullptr);
-
-    if (audio_stream_) {
-        SDL_ResumeAudioStreamDevice(audio_stream_);
-    }
-}
-AI::~AI() {
-    if (audio_stream_) {
-        SDL_DestroyAudioStream(audio_stream_);
-    }
 }
 
+AI::~AI() = default;
+
 template<typename T>
 T AI::read(u32 address) const {
     // TODO: Do smarter
@@ -82,6 +68,7 @@ void AI::write_register(u32 address, u32 value) {
             if (!status_.full) {
                 request_queue_.push(DMA_Request(dram_addr_.address, new_length));
                 status_.busy = 1;
+                if (request_queue_.size() == 1) start_request(request_queue_.front());
                 if (request_queue_.size() == 2) status_.full = 1;
             }
 
@@ -100,21 +87,7 @@ void AI::write_register(u32 address, u32 value) {
             dacrate_.raw = new_dacrate;
             u32 sample_rate = NTSC_VI_FREQ / (dacrate_.dac_rate + 1);
             cycles_per_sample_ = CPU_FREQ / sample_rate;
-
-            if (audio_stream_) {
-                SDL_DestroyAudioStream(audio_stream_);
-            }
-
-            SDL_AudioSpec spec;
-            spec.format = SDL_AUDIO_S16LE;
-            spec.channels = 2;
-            spec.freq = static_cast<s32>(sample_rate);
-
-            audio_stream_ = SDL_OpenAudioDeviceStream(SDL_AUDIO_DEVICE_DEFAULT_PLAYBACK, &spec, nullptr, nullptr);
-
-            if (audio_stream_) {
-                SDL_ResumeAudioStreamDevice(audio_stream_);
-            }
+            output_.set_source_rate(sample_rate);
             break;
         }
         case AI_REGISTERS_ADDRESS::AI_BITRATE:
@@ -125,50 +98,105 @@ void AI::write_register(u32 address, u32 value) {
     }
 }
 
-void AI::process_passed_cycles(u32 cycles) {
-    if (cycles_per_sample_ == 0) return;
+// Converts a whole buffer from big-endian RDRAM to host order and queues it
+void AI::start_request(const DMA_Request& request) {
+    size_t frames = request.remaining / 4;
+    samples_.resize(frames * 2);
 
-    cycles_accumulator_ += cycles;
-    while (cycles_accumulator_ >= cycles_per_sample_) {
-        cycles_accumulator_ -= cycles_per_sample_;
+    if (profiler_) {
+        profiler_->record_dma(memory::AccessProfiler::Dma::AI, request.dram_address, request.remaining, false);
+    }
 
-        if (!status_.busy || !control_.dma_enable) {
-            continue;
+    const u8* src = rdram_.view(request.dram_address, request.remaining);
+    if (!src) {
+        // Runs off the end of RDRAM, where reads return 0
+        for (size_t i = 0; i < frames * 2; i++) {
+            samples_[i] = static_cast<s16>(rdram_.read_memory<u16>(request.dram_address + i * 2));
+        }
+    } else {
+        for (size_t i = 0; i < frames * 2; i++) {
+            samples_[i] = static_cast<s16>((src[i * 2] << 8) | src[i * 2 + 1]);
         }
+    }
+    output_.push(samples_.data(), frames);
+}
 
-        auto& request = request_queue_.front();
+void AI::process_passed_cycles(u32 cycles) {
+    if (cycles_per_sample_ == 0 || !status_.busy || !control_.dma_enable) return;
 
-        u16 left = rdram_.read_memory<u16>(request.dram_address);
-        u16 right = rdram_.read_memory<u16>(request.dram_address + 2);
-        request.dram_address += 4;
-        request.remaining -= 4;
+    cycles_accumulator_ += cycles;
+    if (cycles_accumulator_ < cycles_per_sample_) return;
 
-        sample_buffer_[sample_buffer_pos_++] = static_cast<s16>(left);
-        sample_buffer_[sample_buffer_pos_++] = static_cast<s16>(right);
+    u64 samples = cycles_accumulator_ / cycles_per_sample_;
+    cycles_accumulator_ -= samples * cycles_per_sample_;
+    u64 bytes = samples * 4;
 
-        if (sample_buffer_pos_ >= SAMPLE_BUFFER_SIZE) {
-            if (audio_stream_) {
-                SDL_PutAudioStreamData(audio_stream_, sample_buffer_.data(), sample_buffer_pos_ * sizeof(s16));
-            }
-            sample_buffer_pos_ = 0;
-        }
-        
-        if (request.remaining <= 0) {
-            if (sample_buffer_pos_ > 0 && audio_stream_) {
-                SDL_PutAudioStreamData(audio_stream_, sample_buffer_.data(), sample_buffer_pos_ * sizeof(s16));
-                sample_buffer_pos_ = 0;
-            }
+    while (bytes > 0 && !request_queue_.empty()) {
+        auto& request = request_queue_.front();
+        u32 step = static_cast<u32>(std::min<u64>(bytes, request.remaining));
+        request.dram_address += step;
+        request.remaining -= step;
+        bytes -= step;
+
+        if (request.remaining == 0) {
             request_queue_.pop();
             status_.full = 0;
             if (request_queue_.empty()) {
                 status_.busy = 0;
             } else {
+                start_request(request_queue_.front());
                 mi_.set_interrupt(MI_INTERRUPT_AI);
             }
         }
     }
 }
 
+void AI::save_state(StateWriter& writer) const
+{
+    writer.begin_chunk("AI  ", 1);
+    writer.write(dram_addr_);
+    writer.write(length_);
+    writer.write(control_);
+    writer.write(status_);
+    writer.write(dacrate_);
+    writer.write(bitrate_);
+    writer.write(cycles_accumulator_);
+    writer.write(cycles_per_sample_);
+    // At most two buffers: the one playing and the one queued behind it
+    std::queue<DMA_Request> queue = request_queue_;
+    writer.write(static_cast<u32>(queue.size()));
+    while (!queue.empty()) {
+        writer.write(queue.front().dram_address);
+        writer.write(queue.front().remaining);
+        queue.pop();
+    }
+    writer.end_chunk();
+}
+
+void AI::load_state(StateReader& reader)
+{
+    if (!reader.open_chunk("AI  ", 1)) return;
+    reader.read(dram_addr_);
+    reader.read(length_);
+    reader.read(control_);
+    reader.read(status_);
+    reader.read(dacrate_);
+    reader.read(bitrate_);
+    reader.read(cycles_accumulator_);
+    reader.read(cycles_per_sample_);
+    request_queue_ = {};
+    u32 queued = std::min(reader.read<u32>(), 2u);
+    for (u32 i = 0; i < queued; i++) {
+        u32 dram_address = reader.read<u32>();
+        u32 remaining = reader.read<u32>();
+        request_queue_.emplace(dram_address, remaining);
+    }
+
+    if (cycles_per_sample_ != 0) {
+        output_.set_source_rate(NTSC_VI_FREQ / (dacrate_.dac_rate + 1));
+    }
+}
+
 template u8 AI::read<u8>(u32) const;
 template u16 AI::read<u16>(u32) const;
 template u32 AI::read<u32>(u32) const;
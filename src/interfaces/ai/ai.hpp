@@ -1,12 +1,14 @@
 #pragma once
 
 #include "../../utils/types.hpp"
+#include "../../utils/save_state.hpp"
 #include "../mi.hpp"
 #include "ai_registers.hpp"
 #include "../../memory/rdram.hpp"
+#include "../../memory/access_profiler.hpp"
+#include "audio_output.hpp"
 #include <queue>
-#include <array>
-#include <SDL3/SDL.h>
+#include <vector>
 
 namespace n64::interfaces {
 
@@ -36,12 +38,20 @@ public:
 
     void process_passed_cycles(u32 cycles);
 
+    void set_profiler(memory::AccessProfiler* profiler) { profiler_ = profiler; }
+
+    // A buffer already playing when the state is loaded is not resent to the host
+    void save_state(StateWriter& writer) const;
+    void load_state(StateReader& reader);
+
 private:
     [[nodiscard]] inline u32 get_bytes_remaining() const {return (request_queue_.empty() ? 0 : request_queue_.front().remaining); }
+    void start_request(const DMA_Request& request);
     
     // Dependencies
     MI& mi_;
     memory::RDRAM& rdram_;
+    memory::AccessProfiler* profiler_ = nullptr;
 
     // Registers
     AIDramAddr dram_addr_;
@@ -56,12 +66,11 @@ private:
     u64 cycles_accumulator_ = 0;
     u64 cycles_per_sample_ = 0;
 
-    // SDL audio output
-    SDL_AudioStream* audio_stream_;
-    static constexpr int SAMPLE_BUFFER_SIZE = 128;
-    std::array<s16, SAMPLE_BUFFER_SIZE> sample_buffer_{};
-    int sample_buffer_pos_ = 0;
-
+    // Host audio: each buffer is copied out of RDRAM in one go when its
+    // playback starts; the cycle count above only paces AI_LENGTH and the
+    // interrupt
+    AudioOutput output_;
+    std::vector<s16> samples_;
 };
 
 } // namespace n64::interfaces
\ No newline at end of file
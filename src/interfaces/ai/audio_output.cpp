@@ -0,0 +1,103 @@
+#include "audio_output.hpp"
+#include <algorithm>
+#include <cstdio>
+
+namespace n64::interfaces {
+
+AudioOutput::AudioOutput() {
+    SDL_Init(SDL_INIT_AUDIO);
+
+    SDL_AudioSpec spec;
+    spec.format = SDL_AUDIO_S16;
+    spec.channels = 2;
+    spec.freq = HOST_SAMPLE_RATE;
+
+    stream_ = SDL_OpenAudioDeviceStream(SDL_AUDIO_DEVICE_DEFAULT_PLAYBACK, &spec, stream_callback, this);
+    if (!stream_) {
+        fprintf(stderr, "[AI] Failed to open audio device: %s\n", SDL_GetError());
+        return;
+    }
+    SDL_ResumeAudioStreamDevice(stream_);
+}
+
+AudioOutput::~AudioOutput() {
+    if (stream_) {
+        // Stops the audio thread before the ring goes away
+        SDL_DestroyAudioStream(stream_);
+    }
+    if (callbacks_ > 0) {
+        fprintf(stderr, "[AI] Audio latency: avg %.1f ms, max %.1f ms\n",
+                latency_sum_us_ / 1000.0 / callbacks_, latency_max_us_ / 1000.0);
+    }
+    fprintf(stderr, "[AI] Audio: %llu underruns, %llu frames dropped\n",
+            (unsigned long long)underruns_.load(), (unsigned long long)dropped_frames_.load());
+}
+
+void AudioOutput::push(const s16* frames, size_t count) {
+    size_t stored = ring_.push(frames, count);
+    if (stored < count) {
+        dropped_frames_.fetch_add(count - stored, std::memory_order_relaxed);
+    }
+}
+
+void SDLCALL AudioOutput::stream_callback(void* userdata, SDL_AudioStream* stream, int additional_amount, int) {
+    if (additional_amount <= 0) return;
+    static_cast<AudioOutput*>(userdata)->fill(stream, additional_amount / (2 * sizeof(s16)));
+}
+
+// PI control on the ring fill level. The error is smoothed over a few dozen
+// callbacks so the pitch change stays inaudible; the integral term takes out
+// a steady drift between emulated and host clocks.
+double AudioOutput::rate_correction(u32 source_rate) {
+    double target = TARGET_LATENCY_MS * source_rate / 1000.0;
+    double error = (static_cast<double>(ring_.size()) - target) / target;
+    fill_error_ += (std::clamp(error, -1.0, 1.0) - fill_error_) * 0.05;
+    fill_integral_ = std::clamp(fill_integral_ + fill_error_ * 0.002, -1.0, 1.0);
+    return 1.0 + MAX_RATE_ADJUST * std::clamp(fill_error_ + fill_integral_, -1.0, 1.0);
+}
+
+void AudioOutput::fill(SDL_AudioStream* stream, size_t frames) {
+    if (frames == 0) return;
+
+    u32 source_rate = source_rate_.load(std::memory_order_relaxed);
+    if (source_rate != resampler_rate_) {
+        resampler_.set_rates(source_rate, HOST_SAMPLE_RATE);
+        resampler_rate_ = source_rate;
+    }
+
+    u64 latency_us = (ring_.size() + resampler_.pending()) * 1000000ULL / source_rate
+        + SDL_GetAudioStreamQueued(stream) / (2 * sizeof(s16)) * 1000000ULL / HOST_SAMPLE_RATE;
+    latency_us_.store(latency_us, std::memory_order_relaxed);
+    latency_sum_us_ += latency_us;
+    latency_max_us_ = std::max(latency_max_us_, latency_us);
+    callbacks_++;
+
+    output_.assign(frames * 2, 0);
+
+    // After an underrun, play silence until half the target is buffered again
+    if (buffering_ && ring_.size() < TARGET_LATENCY_MS * source_rate / 2000.0) {
+        SDL_PutAudioStreamData(stream, output_.data(), static_cast<int>(output_.size() * sizeof(s16)));
+        return;
+    }
+    buffering_ = false;
+
+    double step = static_cast<double>(source_rate) / HOST_SAMPLE_RATE * rate_correction(source_rate);
+    size_t needed = resampler_.frames_needed(frames, step);
+    input_.resize(needed * 2);
+    size_t got = ring_.pop(input_.data(), needed);
+    if (got < needed) {
+        // Hold the last frame rather than dropping to zero mid-waveform
+        underruns_.fetch_add(1, std::memory_order_relaxed);
+        buffering_ = true;
+        for (size_t i = got; i < needed; i++) {
+            input_[i * 2] = got ? input_[(got - 1) * 2] : 0;
+            input_[i * 2 + 1] = got ? input_[(got - 1) * 2 + 1] : 0;
+        }
+    }
+    resampler_.append(input_.data(), needed);
+    resampler_.render(output_.data(), frames, step);
+
+    SDL_PutAudioStreamData(stream, output_.data(), static_cast<int>(output_.size() * sizeof(s16)));
+}
+
+} // namespace n64::interfaces
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "../../utils/types.hpp"
+#include "audio_ring.hpp"
+#include "audio_resampler.hpp"
+#include <SDL3/SDL.h>
+#include <atomic>
+#include <vector>
+
+namespace n64::interfaces {
+
+// One playback device opened for the lifetime of the emulator at a fixed host
+// rate. AI buffers are pushed into a lock-free ring from the emulation thread;
+// SDL's audio thread drains it through fill(), resampling from the current
+// DAC rate, so a rate change never touches the device.
+//
+// The resampling step is nudged by up to MAX_RATE_ADJUST around the nominal
+// ratio to hold the ring near TARGET_LATENCY_MS: when emulation runs fast the
+// ring fills and playback speeds up slightly, when it runs slow it drains and
+// playback slows down, instead of latency growing or the ring running dry.
+class AudioOutput {
+public:
+    static constexpr u32 HOST_SAMPLE_RATE = 48000;
+    static constexpr size_t RING_FRAMES = 1 << 14;  // ~0.34s at 48kHz
+    static constexpr double TARGET_LATENCY_MS = 60.0;
+    static constexpr double MAX_RATE_ADJUST = 0.005;
+
+    AudioOutput();
+    ~AudioOutput();
+
+    AudioOutput(const AudioOutput&) = delete;
+    AudioOutput& operator=(const AudioOutput&) = delete;
+
+    void set_source_rate(u32 rate) { source_rate_.store(rate, std::memory_order_relaxed); }
+
+    // Interleaved stereo frames in host byte order
+    void push(const s16* frames, size_t count);
+
+    // Buffered audio (ring plus device queue) at the last callback, and the
+    // number of times the ring ran dry
+    [[nodiscard]] double latency_ms() const { return latency_us_.load(std::memory_order_relaxed) / 1000.0; }
+    [[nodiscard]] u64 underruns() const { return underruns_.load(std::memory_order_relaxed); }
+
+private:
+    static void SDLCALL stream_callback(void* userdata, SDL_AudioStream* stream, int additional_amount, int total_amount);
+    void fill(SDL_AudioStream* stream, size_t frames);
+    [[nodiscard]] double rate_correction(u32 source_rate);
+
+    SDL_AudioStream* stream_ = nullptr;
+    AudioRing<RING_FRAMES> ring_;
+    std::atomic<u32> source_rate_{HOST_SAMPLE_RATE};
+
+    // Audio thread state
+    AudioResampler resampler_;
+    u32 resampler_rate_ = 0;
+    std::vector<s16> input_;
+    std::vector<s16> output_;
+    double fill_error_ = 0.0;     // smoothed, -1..1
+    double fill_integral_ = 0.0;
+    bool buffering_ = true;    // waiting for the ring to refill after an underrun
+
+    std::atomic<u64> underruns_{0};
+    std::atomic<u64> dropped_frames_{0};
+    std::atomic<u64> latency_us_{0};
+    u64 latency_sum_us_ = 0;
+    u64 latency_max_us_ = 0;
+    u64 callbacks_ = 0;
+};
+
+} // namespace n64::interfaces
@@ -0,0 +1,129 @@
+#include "audio_resampler.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace n64::interfaces {
+
+namespace {
+
+constexpr double PI = 3.14159265358979323846;
+constexpr size_t HISTORY = AudioResampler::TAPS / 2 - 1;
+
+#if defined(__SSE2__)
+// Two frames per step: input (L0 R0 L1 R1) against (c0 c0 c1 c1), with the
+// coefficients lerped between adjacent phases
+inline void convolve(const float* in, const float* c0, const float* c1, float frac, float* out) {
+    const __m128 f = _mm_set1_ps(frac);
+    __m128 acc = _mm_setzero_ps();
+    for (u32 k = 0; k < AudioResampler::TAPS * 2; k += 4) {
+        __m128 a = _mm_loadu_ps(c0 + k);
+        __m128 b = _mm_loadu_ps(c1 + k);
+        __m128 coef = _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), f));
+        acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(in + k), coef));
+    }
+    acc = _mm_add_ps(acc, _mm_movehl_ps(acc, acc));
+    out[0] = _mm_cvtss_f32(acc);
+    out[1] = _mm_cvtss_f32(_mm_shuffle_ps(acc, acc, 1));
+}
+#else
+inline void convolve(const float* in, const float* c0, const float* c1, float frac, float* out) {
+    float left = 0.0f;
+    float right = 0.0f;
+    for (u32 k = 0; k < AudioResampler::TAPS * 2; k += 2) {
+        float coef = c0[k] + (c1[k] - c0[k]) * frac;
+        left += in[k] * coef;
+        right += in[k + 1] * coef;
+    }
+    out[0] = left;
+    out[1] = right;
+}
+#endif
+
+inline s16 to_s16(float value) {
+    return static_cast<s16>(std::clamp(std::lrint(value), -32768L, 32767L));
+}
+
+} // namespace
+
+AudioResampler::AudioResampler()
+    : input_(HISTORY * 2, 0.0f)
+    , position_(HISTORY)
+{
+    build_table(0.95);
+}
+
+void AudioResampler::set_rates(u32 source_rate, u32 host_rate) {
+    if (source_rate == 0) return;
+    // Upsampling keeps the source band; downsampling cuts at the host Nyquist
+    double cutoff = 0.95 * std::min(1.0, static_cast<double>(host_rate) / source_rate);
+    if (std::abs(cutoff - cutoff_) > 1e-6) {
+        build_table(cutoff);
+    }
+}
+
+// Blackman-windowed sinc, each phase normalized to unity gain
+void AudioResampler::build_table(double cutoff) {
+    cutoff_ = cutoff;
+    table_.assign((PHASES + 1) * TAPS * 2, 0.0f);
+    for (u32 phase = 0; phase <= PHASES; phase++) {
+        double frac = static_cast<double>(phase) / PHASES;
+        double coefs[TAPS];
+        double sum = 0.0;
+        for (u32 k = 0; k < TAPS; k++) {
+            double t = static_cast<double>(k) - HISTORY - frac;
+            double x = t / (TAPS / 2);
+            double window = std::abs(x) >= 1.0 ? 0.0
+                : 0.42 + 0.5 * std::cos(PI * x) + 0.08 * std::cos(2.0 * PI * x);
+            double sinc = t == 0.0 ? 1.0 : std::sin(PI * cutoff * t) / (PI * cutoff * t);
+            coefs[k] = sinc * window;
+            sum += coefs[k];
+        }
+        float* row = &table_[phase * TAPS * 2];
+        for (u32 k = 0; k < TAPS; k++) {
+            row[k * 2] = row[k * 2 + 1] = static_cast<float>(coefs[k] / sum);
+        }
+    }
+}
+
+size_t AudioResampler::frames_needed(size_t frames, double step) const {
+    if (frames == 0) return 0;
+    double last = position_ + static_cast<double>(frames - 1) * step;
+    size_t required = static_cast<size_t>(last) + TAPS / 2 + 1;
+    size_t have = input_.size() / 2;
+    return required > have ? required - have : 0;
+}
+
+void AudioResampler::append(const s16* frames, size_t count) {
+    size_t offset = input_.size();
+    input_.resize(offset + count * 2);
+    for (size_t i = 0; i < count * 2; i++) {
+        input_[offset + i] = frames[i];
+    }
+}
+
+void AudioResampler::render(s16* out, size_t frames, double step) {
+    for (size_t i = 0; i < frames; i++) {
+        size_t index = static_cast<size_t>(position_);
+        double frac = (position_ - index) * PHASES;
+        u32 phase = static_cast<u32>(frac);
+
+        float sample[2];
+        convolve(&input_[(index - HISTORY) * 2], &table_[phase * TAPS * 2],
+                 &table_[(phase + 1) * TAPS * 2], static_cast<float>(frac - phase), sample);
+        out[i * 2] = to_s16(sample[0]);
+        out[i * 2 + 1] = to_s16(sample[1]);
+        position_ += step;
+    }
+
+    // Keep the window history for the next call
+    size_t keep_from = std::min(static_cast<size_t>(position_) - HISTORY, input_.size() / 2);
+    input_.erase(input_.begin(), input_.begin() + keep_from * 2);
+    position_ -= static_cast<double>(keep_from);
+}
+
+} // namespace n64::interfaces
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "../../utils/types.hpp"
+#include <cstddef>
+#include <vector>
+
+namespace n64::interfaces {
+
+// Polyphase windowed-sinc resampler for interleaved stereo. Input frames are
+// appended as they arrive; render() produces output frames at a given step
+// (input frames per output frame), which may change on every call. The
+// filter cutoff follows the nominal ratio set with set_rates().
+class AudioResampler {
+public:
+    static constexpr u32 TAPS = 16;
+    static constexpr u32 PHASES = 256;
+
+    AudioResampler();
+
+    void set_rates(u32 source_rate, u32 host_rate);
+
+    // Input frames still to append before render(frames, step) can run
+    [[nodiscard]] size_t frames_needed(size_t frames, double step) const;
+    void append(const s16* frames, size_t count);
+    void render(s16* out, size_t frames, double step);
+
+    // Appended frames not yet consumed
+    [[nodiscard]] size_t pending() const { return input_.size() / 2 - static_cast<size_t>(position_); }
+
+private:
+    void build_table(double cutoff);
+
+    // Per phase, TAPS coefficients each stored twice (left and right lanes),
+    // plus one extra phase so that phase + 1 can always be read
+    std::vector<float> table_;
+    double cutoff_ = 0.0;
+
+    std::vector<float> input_;  // interleaved, starts TAPS / 2 - 1 frames before position_
+    double position_ = 0.0;
+};
+
+} // namespace n64::interfaces
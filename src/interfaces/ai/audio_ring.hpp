@@ -0,0 +1,66 @@
+#pragma once
+
+#include "../../utils/types.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+
+namespace n64::interfaces {
+
+// Single-producer single-consumer ring of interleaved stereo s16 frames.
+// The emulation thread pushes whole AI buffers, the audio thread pops.
+// Capacity must be a power of two; positions are free-running counters.
+template<size_t CAPACITY>
+class AudioRing {
+    static_assert((CAPACITY & (CAPACITY - 1)) == 0, "capacity must be a power of two");
+
+public:
+    static constexpr size_t capacity() { return CAPACITY; }
+
+    [[nodiscard]] size_t size() const {
+        return write_pos_.load(std::memory_order_acquire) - read_pos_.load(std::memory_order_acquire);
+    }
+
+    // Producer side. Returns the number of frames stored; the rest did not fit.
+    size_t push(const s16* frames, size_t count) {
+        size_t write = write_pos_.load(std::memory_order_relaxed);
+        size_t read = read_pos_.load(std::memory_order_acquire);
+        count = std::min(count, CAPACITY - (write - read));
+        copy_in(write, frames, count);
+        write_pos_.store(write + count, std::memory_order_release);
+        return count;
+    }
+
+    // Consumer side. Returns the number of frames read.
+    size_t pop(s16* frames, size_t count) {
+        size_t read = read_pos_.load(std::memory_order_relaxed);
+        size_t write = write_pos_.load(std::memory_order_acquire);
+        count = std::min(count, write - read);
+        copy_out(read, frames, count);
+        read_pos_.store(read + count, std::memory_order_release);
+        return count;
+    }
+
+private:
+    void copy_in(size_t pos, const s16* src, size_t count) {
+        size_t start = pos & (CAPACITY - 1);
+        size_t first = std::min(count, CAPACITY - start);
+        std::memcpy(&buffer_[start * 2], src, first * 4);
+        std::memcpy(&buffer_[0], src + first * 2, (count - first) * 4);
+    }
+
+    void copy_out(size_t pos, s16* dst, size_t count) const {
+        size_t start = pos & (CAPACITY - 1);
+        size_t first = std::min(count, CAPACITY - start);
+        std::memcpy(dst, &buffer_[start * 2], first * 4);
+        std::memcpy(dst + first * 2, &buffer_[0], (count - first) * 4);
+    }
+
+    std::array<s16, CAPACITY * 2> buffer_{};
+    alignas(64) std::atomic<size_t> write_pos_{0};
+    alignas(64) std::atomic<size_t> read_pos_{0};
+};
+
+} // namespace n64::interfaces
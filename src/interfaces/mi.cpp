@@ -72,6 +72,25 @@ bool MI::check_interrupts() const {
     return (interrupt_ & mask_) != 0;
 }
 
+void MI::save_state(StateWriter& writer) const
+{
+    writer.begin_chunk("MI  ", 1);
+    writer.write(mode_);
+    writer.write(version_);
+    writer.write(interrupt_);
+    writer.write(mask_);
+    writer.end_chunk();
+}
+
+void MI::load_state(StateReader& reader)
+{
+    if (!reader.open_chunk("MI  ", 1)) return;
+    reader.read(mode_);
+    reader.read(version_);
+    reader.read(interrupt_);
+    reader.read(mask_);
+}
+
 template u8 MI::read<u8>(u32) const;
 template u16 MI::read<u16>(u32) const;
 template u32 MI::read<u32>(u32) const;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../utils/types.hpp"
+#include "../utils/save_state.hpp"
 
 namespace n64::interfaces {
 
@@ -40,6 +41,9 @@ public:
     [[nodiscard]] u32 interrupt_reg() const { return interrupt_; }
     [[nodiscard]] u32 mask_reg() const { return mask_; }
 
+    void save_state(StateWriter& writer) const;
+    void load_state(StateReader& reader);
+
 private:
     u32 mode_;
     u32 version_;
@@ -2,6 +2,9 @@
 #include "../../memory/memory_constants.hpp"
 #include "../../memory/rom.hpp"
 #include "../../memory/rdram.hpp"
+#include "../../memory/cart_save.hpp"
+#include "../../memory/access_profiler.hpp"
+#include <algorithm>
 
 namespace n64::interfaces {
 
@@ -21,10 +24,6 @@ PI::PI(MI& mi)
     , bsd_dom2_pgs_{.raw = 0}
     , bsd_dom2_rls_{.raw = 0}
     , dma_busy_(false)
-    , pi_cycle_accumulator_(0.0f)
-    , latency_counter_(0)
-    , pulse_width_counter_(0)
-    , release_counter_(0)
     , is_reading_(false)
     , is_writing_(false)
 {
@@ -32,9 +31,10 @@ PI::PI(MI& mi)
 
 PI::~PI() {}
 
-void PI::set_dma_targets(memory::ROM& rom, memory::RDRAM& rdram) {
+void PI::set_dma_targets(memory::ROM& rom, memory::RDRAM& rdram, memory::CartSave& cart_save) {
     rom_ = &rom;
     rdram_ = &rdram;
+    cart_save_ = &cart_save;
 }
 
 u32 PI::read_register(u32 address) const {
@@ -85,19 +85,15 @@ void PI::write_register(u32 address, u32 value) {
             rd_len_.raw = value & 0x00FFFFFF;
             fprintf(stderr, "[PI] DMA start RDRAM->Cart: dram=0x%08X -> cart=0x%08X len=0x%X\n",
                     dram_addr_.raw, cart_addr_.raw, rd_len_.raw + 1);
-            dma_busy_ = true;
-            status_.dma_busy = 1;
-            set_counters();
             is_writing_ = true;
+            start_dma(rd_len_.raw + 1);
             break;
         case PI_WR_LEN:
             wr_len_.raw = value & 0x00FFFFFF;
             fprintf(stderr, "[PI] DMA start Cart->RDRAM: cart=0x%08X -> dram=0x%08X len=0x%X\n",
                     cart_addr_.raw, dram_addr_.raw, wr_len_.raw + 1);
-            dma_busy_ = true;
-            status_.dma_busy = 1;
-            set_counters();
             is_reading_ = true;
+            start_dma(wr_len_.raw + 1);
             break;
         case PI_STATUS:
             // Writing to status register
@@ -107,6 +103,7 @@ void PI::write_register(u32 address, u32 value) {
             }
             if (value & 0x01) {  // Bit 0: Reset DMA controller
                 dma_busy_ = false;
+                dma_remaining_ = 0;
                 status_.dma_busy = 0;
                 is_reading_ = false;
                 is_writing_ = false;
@@ -143,37 +140,25 @@ void PI::write_register(u32 address, u32 value) {
 
 void PI::process_passed_cycles(u32 cycles) {
     if (!dma_busy_) return;
-    
-    pi_cycle_accumulator_ += cycles * PI_CYCLE_PER_CYCLE_FP;
 
-    // Wait for latency
-    while (latency_counter_ > 0 && pi_cycle_accumulator_ >= 1) {
-        latency_counter_--;
-        pi_cycle_accumulator_ -= 1;
-    }
-    if (latency_counter_ > 0) return;
+    dma_clock_ += static_cast<u64>(cycles) * PI_CLOCK_UNITS_PER_CYCLE;
+    if (dma_clock_ < page_cost_) return;
 
-    // Wait for pulse width (transfer time)
-    while (pulse_width_counter_ > 0 && pi_cycle_accumulator_ >= 1) {
-        pulse_width_counter_--;
-        pi_cycle_accumulator_ -= 1;
+    // Every page that finished in this step, as one contiguous range
+    u32 cart_start = cart_addr_.raw;
+    u32 dram_start = dram_addr_.raw;
+    u32 length = 0;
+    while (dma_remaining_ > 0 && dma_clock_ >= page_cost_) {
+        dma_clock_ -= page_cost_;
+        cart_addr_.raw += page_bytes_;
+        dram_addr_.raw += page_bytes_;
+        dma_remaining_ -= page_bytes_;
+        length += page_bytes_;
+        next_page();
     }
-    if (pulse_width_counter_ > 0) return;
-
-    // Transfer one page of data
-    transfer_page();
+    move_data(cart_start, dram_start, length);
 
-    // Wait for release
-    while (release_counter_ > 0 && pi_cycle_accumulator_ >= 1) {
-        release_counter_--;
-        pi_cycle_accumulator_ -= 1;
-    }
-    if (release_counter_ > 0) return;
-
-    // Check if transfer complete
-    // is_reading_ (Cart→RDRAM) uses wr_len_, is_writing_ (RDRAM→Cart) uses rd_len_
-    u32& len = is_reading_ ? wr_len_.raw : rd_len_.raw;
-    if (len == 0) {
+    if (dma_remaining_ == 0) {
         fprintf(stderr, "[PI] DMA complete: cart=0x%08X dram=0x%08X %s\n",
                 cart_addr_.raw, dram_addr_.raw,
                 is_reading_ ? "READ(cart->dram)" : "WRITE(dram->cart)");
@@ -181,11 +166,8 @@ void PI::process_passed_cycles(u32 cycles) {
         status_.dma_busy = 0;
         is_reading_ = false;
         is_writing_ = false;
-        pi_cycle_accumulator_ = 0.0f;
+        dma_clock_ = 0;
         mi_.set_interrupt(MI_INTERRUPT_PI);
-    } else {
-        // More pages to transfer, reset counters for next page
-        set_counters();
     }
 }
 
@@ -202,58 +184,112 @@ u8 PI::get_address_domain(u32 address) const {
     return 1;
 }
 
-void PI::set_counters() {
-    if (get_address_domain(cart_addr_.raw) == 1) {
-        latency_counter_ = bsd_dom1_lat_.latency;
-        pulse_width_counter_ = bsd_dom1_pwd_.pulse_width;
-        release_counter_ = bsd_dom1_rls_.release;
-    } else {
-        latency_counter_ = bsd_dom2_lat_.latency;
-        pulse_width_counter_ = bsd_dom2_pwd_.pulse_width;
-        release_counter_ = bsd_dom2_rls_.release;
-    }
+void PI::start_dma(u32 length) {
+    dma_busy_ = true;
+    status_.dma_busy = 1;
+    dma_remaining_ = length;
+    dma_clock_ = 0;
+    next_page();
 }
 
-void PI::transfer_page() {
-    if (!rom_ || !rdram_) return;
-    
-    // Get page size based on domain
-    const PIBsdPgs& pgs = (get_address_domain(cart_addr_.raw) == 1) 
-        ? bsd_dom1_pgs_ 
-        : bsd_dom2_pgs_;
-    
+// Size and cost of the page starting at the current cart address, from the
+// BSD registers of its domain
+void PI::next_page() {
+    bool domain1 = get_address_domain(cart_addr_.raw) == 1;
+    const PIBsdLat& lat = domain1 ? bsd_dom1_lat_ : bsd_dom2_lat_;
+    const PIBsdPwd& pwd = domain1 ? bsd_dom1_pwd_ : bsd_dom2_pwd_;
+    const PIBsdPgs& pgs = domain1 ? bsd_dom1_pgs_ : bsd_dom2_pgs_;
+    const PIBsdRls& rls = domain1 ? bsd_dom1_rls_ : bsd_dom2_rls_;
+
     u32 page_size = 1u << (pgs.page_size + 2);
-    u32 page_mask = page_size - 1;
-    
-    // Calculate bytes until page boundary
-    u32 bytes_in_page = page_size - (cart_addr_.raw & page_mask);
-    
-    // Don't transfer more than remaining length
-    // is_reading_ (Cart→RDRAM) uses wr_len_, is_writing_ (RDRAM→Cart) uses rd_len_
-    u32& len = is_reading_ ? wr_len_.raw : rd_len_.raw;
-    u32 bytes_to_transfer = (bytes_in_page < len + 1) ? bytes_in_page : (len + 1);
-    
+    u32 bytes_in_page = page_size - (cart_addr_.raw & (page_size - 1));
+    page_bytes_ = std::min(bytes_in_page, dma_remaining_);
+
+    u64 words = (page_bytes_ + 1) / 2;
+    u64 pi_cycles = (lat.latency + 1) + ((pwd.pulse_width + 1) + (rls.release + 1)) * words;
+    page_cost_ = pi_cycles * PI_CLOCK_UNITS_PER_PI_CYCLE;
+}
+
+void PI::move_data(u32 cart_addr, u32 dram_addr, u32 length) {
+    if (!rom_ || !rdram_ || !cart_save_ || length == 0) return;
+
+    // Bytes that would fall past the end of RDRAM are dropped, like single
+    // accesses
+    u32 dram = dram_addr & 0x00FFFFFF;
+    if (dram >= memory::RDRAM_MEMORY_SIZE) return;
+    u32 in_range = std::min(length, memory::RDRAM_MEMORY_SIZE - dram);
+    bool backup = cart_addr >= memory::PI_DOM2_ADDR2_START && cart_addr <= memory::PI_DOM2_ADDR2_END;
+
     if (is_reading_) {
         // Cart -> RDRAM
-        for (u32 i = 0; i < bytes_to_transfer; i++) {
-            u8 byte = rom_->read<u8>(cart_addr_.raw);
-            rdram_->write_memory<u8>(dram_addr_.raw, byte);
-            cart_addr_.raw++;
-            dram_addr_.raw++;
+        const u8* src = backup ? nullptr : rom_->view(cart_addr, in_range);
+        if (!src) {
+            dma_buffer_.resize(in_range);
+            if (backup) {
+                cart_save_->dma_read(cart_addr, dma_buffer_.data(), in_range);
+            } else {
+                rom_->read_block(cart_addr, dma_buffer_.data(), in_range);
+            }
+            src = dma_buffer_.data();
         }
-    } else if (is_writing_) {
-        // RDRAM -> Cart (SRAM/FlashRAM)
-        // TODO: Implement SRAM/FlashRAM writes
-        cart_addr_.raw += bytes_to_transfer;
-        dram_addr_.raw += bytes_to_transfer;
-    }
-    
-    // Update remaining length
-    if (len >= bytes_to_transfer) {
-        len -= bytes_to_transfer;
-    } else {
-        len = 0;
+        rdram_->write_block(dram, src, in_range);
+        if (profiler_) profiler_->record_dma(memory::AccessProfiler::Dma::PI, dram, in_range, true);
+    } else if (is_writing_ && backup) {
+        // RDRAM -> SRAM/FlashRAM
+        cart_save_->dma_write(cart_addr, rdram_->view(dram, in_range), in_range);
+        if (profiler_) profiler_->record_dma(memory::AccessProfiler::Dma::PI, dram, in_range, false);
     }
 }
 
+void PI::save_state(StateWriter& writer) const
+{
+    writer.begin_chunk("PI  ", 1);
+    writer.write(dram_addr_);
+    writer.write(cart_addr_);
+    writer.write(rd_len_);
+    writer.write(wr_len_);
+    writer.write(status_);
+    writer.write(bsd_dom1_lat_);
+    writer.write(bsd_dom1_pwd_);
+    writer.write(bsd_dom1_pgs_);
+    writer.write(bsd_dom1_rls_);
+    writer.write(bsd_dom2_lat_);
+    writer.write(bsd_dom2_pwd_);
+    writer.write(bsd_dom2_pgs_);
+    writer.write(bsd_dom2_rls_);
+    writer.write(dma_busy_);
+    writer.write(is_reading_);
+    writer.write(is_writing_);
+    writer.write(dma_remaining_);
+    writer.write(page_bytes_);
+    writer.write(page_cost_);
+    writer.write(dma_clock_);
+    writer.end_chunk();
+}
+
+void PI::load_state(StateReader& reader)
+{
+    if (!reader.open_chunk("PI  ", 1)) return;
+    reader.read(dram_addr_);
+    reader.read(cart_addr_);
+    reader.read(rd_len_);
+    reader.read(wr_len_);
+    reader.read(status_);
+    reader.read(bsd_dom1_lat_);
+    reader.read(bsd_dom1_pwd_);
+    reader.read(bsd_dom1_pgs_);
+    reader.read(bsd_dom1_rls_);
+    reader.read(bsd_dom2_lat_);
+    reader.read(bsd_dom2_pwd_);
+    reader.read(bsd_dom2_pgs_);
+    reader.read(bsd_dom2_rls_);
+    reader.read(dma_busy_);
+    reader.read(is_reading_);
+    reader.read(is_writing_);
+    reader.read(dma_remaining_);
+    reader.read(page_bytes_);
+    reader.read(page_cost_);
+    reader.read(dma_clock_);
+}
+
 } // namespace n64::interfaces
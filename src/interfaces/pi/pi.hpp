@@ -1,17 +1,24 @@
 #pragma once
 
 #include "../../utils/types.hpp"
+#include "../../utils/save_state.hpp"
 #include "../mi.hpp"
 #include "pi_registers.hpp"
+#include <vector>
 
 namespace n64::memory {
     class ROM;
     class RDRAM;
+    class CartSave;
+    class AccessProfiler;
 }
 
 namespace n64::interfaces {
 
-constexpr float PI_CYCLE_PER_CYCLE_FP = 2.0f / 3.0f;
+// The PI bus runs at 2/3 of the CPU clock. DMA time is kept in thirds of a
+// PI cycle so the conversion stays in integers.
+constexpr u32 PI_CLOCK_UNITS_PER_CYCLE = 2;     // per CPU cycle
+constexpr u32 PI_CLOCK_UNITS_PER_PI_CYCLE = 3;
 
 class PI {
 public:
@@ -19,13 +26,17 @@ public:
     ~PI();
 
     // Must be called after ROM and RDRAM are constructed
-    void set_dma_targets(memory::ROM& rom, memory::RDRAM& rdram);
+    void set_dma_targets(memory::ROM& rom, memory::RDRAM& rdram, memory::CartSave& cart_save);
+    void set_profiler(memory::AccessProfiler* profiler) { profiler_ = profiler; }
 
     [[nodiscard]] u32 read_register(u32 address) const;
     void write_register(u32 address, u32 value);
 
     void process_passed_cycles(u32 cycles);
 
+    void save_state(StateWriter& writer) const;
+    void load_state(StateReader& reader);
+
     // Accessors for registers
     [[nodiscard]] const PIDramAddr& dram_addr() const { return dram_addr_; }
     [[nodiscard]] const PICartAddr& cart_addr() const { return cart_addr_; }
@@ -34,12 +45,15 @@ public:
 private:
     // Returns 1 for Domain 1, 2 for Domain 2
     [[nodiscard]] u8 get_address_domain(u32 address) const;
-    void set_counters();
-    void transfer_page();
+    void start_dma(u32 length);
+    void next_page();
+    void move_data(u32 cart_addr, u32 dram_addr, u32 length);
 
     MI& mi_;
     memory::ROM* rom_ = nullptr;
     memory::RDRAM* rdram_ = nullptr;
+    memory::CartSave* cart_save_ = nullptr;
+    memory::AccessProfiler* profiler_ = nullptr;
 
     // Registers
     PIDramAddr dram_addr_;
@@ -60,14 +74,18 @@ private:
     PIBsdPgs bsd_dom2_pgs_;
     PIBsdRls bsd_dom2_rls_;
 
-    // DMA state
+    // DMA state. The BSD registers of the page's domain hold each timing
+    // minus one; a page costs (latency + 1) PI cycles to open, then
+    // (pulse width + 1) + (release + 1) for every 16-bit word it carries.
+    // Pages that complete within the elapsed time are moved together.
     bool dma_busy_;
-    float pi_cycle_accumulator_;
-    u32 latency_counter_;
-    u32 pulse_width_counter_;
-    u32 release_counter_;
     bool is_reading_;
     bool is_writing_;
+    u32 dma_remaining_ = 0;   // bytes
+    u32 page_bytes_ = 0;      // bytes in the page in flight
+    u64 page_cost_ = 0;       // clock units for one page
+    u64 dma_clock_ = 0;       // clock units elapsed in the page in flight
+    std::vector<u8> dma_buffer_;
 };
 
 } // namespace n64::interfaces
@@ -79,6 +79,33 @@ void RI::write_register(u32 address, u32 value) {
     }
 }
 
+void RI::save_state(StateWriter& writer) const
+{
+    writer.begin_chunk("RI  ", 1);
+    writer.write(mode_);
+    writer.write(config_);
+    writer.write(current_load_);
+    writer.write(select_);
+    writer.write(refresh_);
+    writer.write(latency_);
+    writer.write(error_);
+    writer.write(bank_status_);
+    writer.end_chunk();
+}
+
+void RI::load_state(StateReader& reader)
+{
+    if (!reader.open_chunk("RI  ", 1)) return;
+    reader.read(mode_);
+    reader.read(config_);
+    reader.read(current_load_);
+    reader.read(select_);
+    reader.read(refresh_);
+    reader.read(latency_);
+    reader.read(error_);
+    reader.read(bank_status_);
+}
+
 template u8 RI::read<u8>(u32) const;
 template u16 RI::read<u16>(u32) const;
 template u32 RI::read<u32>(u32) const;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../utils/types.hpp"
+#include "../utils/save_state.hpp"
 
 namespace n64::interfaces {
 
@@ -28,6 +29,9 @@ public:
     [[nodiscard]] u32 read_register(u32 address) const;
     void write_register(u32 address, u32 value);
 
+    void save_state(StateWriter& writer) const;
+    void load_state(StateReader& reader);
+
 private:
     u32 mode_;
     u32 config_;
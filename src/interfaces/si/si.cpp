@@ -1,4 +1,5 @@
 #include "si.hpp"
+#include "../../memory/memory_constants.hpp"
 #include <cstdio>
 
 namespace n64::interfaces {
@@ -52,29 +53,24 @@ void SI::write_register(u32 address, u32 value) {
             dram_addr_.raw = value & 0x00FFFFFF;
             break;
         case SI_REGISTERS_ADDRESS::SI_PIF_AD_RD64B:
-            fprintf(stderr, "[SI] DMA Read (PIF->RDRAM) dram=0x%08X\n", dram_addr_.address);
             pif_ad_rd64b_.raw = value & 0x000007FC;
-            pif_.dma_read_to_rdram(rdram_, dram_addr_.address);
-            mi_.set_interrupt(MI_INTERRUPT_SI);
-            status_.interrupt = 1;
+            start(Transfer::ReadBlock, value, SI_DMA_64B_CYCLES);
             break;
         case SI_REGISTERS_ADDRESS::SI_PIF_AD_WR4B:
-            // !! Broken
             pif_ad_wr4b_.raw = value;
+            start(Transfer::WriteWord, value, SI_DMA_4B_CYCLES);
             break;
         case SI_REGISTERS_ADDRESS::SI_PIF_AD_WR64B:
-            fprintf(stderr, "[SI] DMA Write (RDRAM->PIF) dram=0x%08X\n", dram_addr_.address);
             pif_ad_wr64b_.raw = value;
-            pif_.dma_write_from_rdram(rdram_, dram_addr_.address);
-            mi_.set_interrupt(MI_INTERRUPT_SI);
-            status_.interrupt = 1;
+            start(Transfer::WriteBlock, value, SI_DMA_64B_CYCLES);
             break;
         case SI_REGISTERS_ADDRESS::SI_PIF_AD_RD4B:
-            // !! Broken
             pif_ad_rd4b_.raw = value;
+            start(Transfer::ReadWord, value, SI_DMA_4B_CYCLES);
             break;
         case SI_REGISTERS_ADDRESS::SI_STATUS:
             // Writing any value clears SI interrupt
+            status_.interrupt = 0;
             mi_.clear_interrupt(MI_INTERRUPT_SI);
             break;
         default:
@@ -82,6 +78,116 @@ void SI::write_register(u32 address, u32 value) {
     }
 }
 
+// A transfer started while another is in flight is dropped, as the
+// hardware ignores it
+void SI::start(Transfer transfer, u32 pif_address, u32 cycles) {
+    if (transfer_ != Transfer::None) {
+        fprintf(stderr, "[SI] Transfer started while busy, ignored\n");
+        return;
+    }
+    transfer_ = transfer;
+    transfer_pif_address_ = pif_address;
+    transfer_cycles_ = cycles;
+    if (transfer == Transfer::ReadBlock || transfer == Transfer::WriteBlock) {
+        status_.dma_busy = 1;
+    } else {
+        status_.io_busy = 1;
+    }
+}
+
+void SI::process_passed_cycles(u32 cycles) {
+    if (transfer_ == Transfer::None) return;
+    if (cycles < transfer_cycles_) {
+        transfer_cycles_ -= cycles;
+        return;
+    }
+    finish();
+}
+
+// Data moves at completion, so the CPU never sees a half-done transfer
+void SI::finish() {
+    u32 dram_addr = dram_addr_.address;
+    // Word transfers address PIF RAM by the low bits; PIF ROM is not readable
+    u32 pif_word = memory::PIF_START_ADDRESS + (transfer_pif_address_ & 0x3C);
+
+    switch (transfer_) {
+        case Transfer::ReadBlock:
+            pif_.dma_read_to_rdram(rdram_, dram_addr);
+            break;
+        case Transfer::WriteBlock:
+            pif_.dma_write_from_rdram(rdram_, dram_addr);
+            break;
+        case Transfer::ReadWord:
+            rdram_.write_memory<u32>(dram_addr, pif_.read<u32>(pif_word));
+            break;
+        case Transfer::WriteWord:
+            pif_.write<u32>(pif_word, rdram_.read_memory<u32>(dram_addr));
+            // The PIF acts on its command byte as soon as it is written
+            if (pif_word == memory::PIF_END_ADDRESS - 3) pif_.process_commands();
+            break;
+        case Transfer::None:
+            return;
+    }
+
+    if (profiler_) {
+        bool block = transfer_ == Transfer::ReadBlock || transfer_ == Transfer::WriteBlock;
+        bool to_rdram = transfer_ == Transfer::ReadBlock || transfer_ == Transfer::ReadWord;
+        profiler_->record_dma(memory::AccessProfiler::Dma::SI, dram_addr, block ? 64 : 4, to_rdram);
+    }
+
+    transfer_ = Transfer::None;
+    transfer_cycles_ = 0;
+    status_.dma_busy = 0;
+    status_.io_busy = 0;
+    status_.interrupt = 1;
+    mi_.set_interrupt(MI_INTERRUPT_SI);
+}
+
+void SI::save_state(StateWriter& writer) const
+{
+    writer.begin_chunk("SI  ", 2);
+    writer.write(dram_addr_);
+    writer.write(pif_ad_rd64b_);
+    writer.write(pif_ad_wr4b_);
+    writer.write(pif_ad_wr64b_);
+    writer.write(pif_ad_rd4b_);
+    writer.write(status_);
+    writer.write(transfer_);
+    writer.write(transfer_pif_address_);
+    writer.write(transfer_cycles_);
+    writer.end_chunk();
+}
+
+bool SI::check_state(StateReader& reader) const
+{
+    if (!reader.open_chunk("SI  ", 2)) return false;
+    size_t size = sizeof(dram_addr_) + sizeof(pif_ad_rd64b_) + sizeof(pif_ad_wr4b_)
+                + sizeof(pif_ad_wr64b_) + sizeof(pif_ad_rd4b_) + sizeof(status_);
+    if (reader.chunk_version() >= 2) {
+        size += sizeof(transfer_) + sizeof(transfer_pif_address_) + sizeof(transfer_cycles_);
+    }
+    return reader.remaining() == size;
+}
+
+void SI::load_state(StateReader& reader)
+{
+    if (!reader.open_chunk("SI  ", 2)) return;
+    reader.read(dram_addr_);
+    reader.read(pif_ad_rd64b_);
+    reader.read(pif_ad_wr4b_);
+    reader.read(pif_ad_wr64b_);
+    reader.read(pif_ad_rd4b_);
+    reader.read(status_);
+    transfer_ = Transfer::None;
+    transfer_pif_address_ = 0;
+    transfer_cycles_ = 0;
+    if (reader.chunk_version() >= 2) {
+        reader.read(transfer_);
+        reader.read(transfer_pif_address_);
+        reader.read(transfer_cycles_);
+    }
+}
+
 template u8 SI::read<u8>(u32) const;
 template u16 SI::read<u16>(u32) const;
 template u32 SI::read<u32>(u32) const;
@@ -1,13 +1,20 @@
 #pragma once
 
 #include "../../utils/types.hpp"
+#include "../../utils/save_state.hpp"
 #include "../mi.hpp"
 #include "../../memory/rdram.hpp"
 #include "../../memory/pif.hpp"
+#include "../../memory/access_profiler.hpp"
 #include "si_registers.hpp"
 
 namespace n64::interfaces {
 
+// Approximate SI transfer times in CPU cycles: a 64-byte block to or from
+// PIF RAM, and a single word
+constexpr u32 SI_DMA_64B_CYCLES = 4608;
+constexpr u32 SI_DMA_4B_CYCLES = 1152;
+
 class SI {
 public:
     SI(MI& mi, memory::RDRAM& rdram, memory::PIF& pif);
@@ -21,10 +28,21 @@ public:
     [[nodiscard]] u32 read_register(u32 address) const;
     void write_register(u32 address, u32 value);
 
+    // Transfers move data and raise the interrupt when their time is up;
+    // until then SI_STATUS reports busy
+    void process_passed_cycles(u32 cycles);
+
+    void set_profiler(memory::AccessProfiler* profiler) { profiler_ = profiler; }
+
+    void save_state(StateWriter& writer) const;
+    void load_state(StateReader& reader);
+    [[nodiscard]] bool check_state(StateReader& reader) const;
+
 private:
     MI& mi_;
     memory::RDRAM& rdram_;
     memory::PIF& pif_;
+    memory::AccessProfiler* profiler_ = nullptr;
     
     SIDramAddr dram_addr_;
     SIPIFAdRD64B pif_ad_rd64b_;
@@ -32,5 +50,14 @@ private:
     SIPIFAdWR64B pif_ad_wr64b_;
     SIPIFAdRD4B pif_ad_rd4b_;
     SIStatus status_;
+
+    enum class Transfer : u8 { None, ReadBlock, WriteBlock, ReadWord, WriteWord };
+
+    void start(Transfer transfer, u32 pif_address, u32 cycles);
+    void finish();
+
+    Transfer transfer_ = Transfer::None;
+    u32 transfer_pif_address_ = 0;
+    u32 transfer_cycles_ = 0;  // left until completion
 };
 }
\ No newline at end of file
@@ -0,0 +1,219 @@
+#include "frame_sink.hpp"
+
+#include <algorithm>
+#include <array>
+
+namespace n64::interfaces {
+
+namespace {
+
+const std::array<u32, 256> crc_table = [] {
+    std::array<u32, 256> table{};
+    for (u32 i = 0; i < 256; i++) {
+        u32 c = i;
+        for (u32 k = 0; k < 8; k++) {
+            c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+        }
+        table[i] = c;
+    }
+    return table;
+}();
+
+void put_be32(std::vector<u8>& out, u32 value) {
+    out.push_back(value >> 24);
+    out.push_back(value >> 16);
+    out.push_back(value >> 8);
+    out.push_back(value);
+}
+
+void write_chunk(std::FILE* file, const char* type, const std::vector<u8>& data) {
+    std::vector<u8> chunk;
+    put_be32(chunk, static_cast<u32>(data.size()));
+    chunk.insert(chunk.end(), type, type + 4);
+    chunk.insert(chunk.end(), data.begin(), data.end());
+    put_be32(chunk, crc32(chunk.data() + 4, chunk.size() - 4));
+    std::fwrite(chunk.data(), 1, chunk.size(), file);
+}
+
+} // namespace
+
+u32 crc32(const u8* data, size_t length, u32 crc) {
+    crc = ~crc;
+    for (size_t i = 0; i < length; i++) {
+        crc = crc_table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+// No zlib here, so the image data goes into stored (uncompressed) deflate
+// blocks: valid PNG, just not small
+bool write_png(const std::string& path, const u32* pixels, u32 width, u32 height) {
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        fprintf(stderr, "[VI] Failed to open %s\n", path.c_str());
+        return false;
+    }
+
+    static constexpr u8 signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    std::fwrite(signature, 1, sizeof(signature), file);
+
+    std::vector<u8> header;
+    put_be32(header, width);
+    put_be32(header, height);
+    header.insert(header.end(), {8, 6, 0, 0, 0});  // 8-bit RGBA, no interlace
+    write_chunk(file, "IHDR", header);
+
+    // Scanlines, each prefixed with filter type 0
+    size_t row_bytes = static_cast<size_t>(width) * 4;
+    std::vector<u8> raw;
+    raw.reserve((row_bytes + 1) * height);
+    for (u32 y = 0; y < height; y++) {
+        raw.push_back(0);
+        const u8* row = reinterpret_cast<const u8*>(pixels + static_cast<size_t>(y) * width);
+        raw.insert(raw.end(), row, row + row_bytes);
+    }
+
+    std::vector<u8> zlib = {0x78, 0x01};
+    u32 adler_a = 1;
+    u32 adler_b = 0;
+    for (size_t offset = 0; offset < raw.size() || offset == 0; ) {
+        size_t length = std::min<size_t>(raw.size() - offset, 0xFFFF);
+        bool last = offset + length == raw.size();
+        zlib.push_back(last ? 1 : 0);
+        zlib.push_back(length & 0xFF);
+        zlib.push_back(length >> 8);
+        zlib.push_back(~length & 0xFF);
+        zlib.push_back((~length >> 8) & 0xFF);
+        for (size_t i = offset; i < offset + length; i++) {
+            adler_a = (adler_a + raw[i]) % 65521;
+            adler_b = (adler_b + adler_a) % 65521;
+        }
+        zlib.insert(zlib.end(), raw.begin() + offset, raw.begin() + offset + length);
+        offset += length;
+        if (last) break;
+    }
+    put_be32(zlib, (adler_b << 16) | adler_a);
+    write_chunk(file, "IDAT", zlib);
+    write_chunk(file, "IEND", {});
+
+    std::fclose(file);
+    return true;
+}
+
+HashSink::HashSink(const std::string& path) {
+    file_ = (path == "-") ? stdout : std::fopen(path.c_str(), "w");
+    if (!file_) {
+        fprintf(stderr, "[VI] Failed to open hash file %s\n", path.c_str());
+    }
+}
+
+HashSink::~HashSink() {
+    if (file_ && file_ != stdout) {
+        std::fclose(file_);
+    }
+}
+
+void HashSink::consume(const CapturedFrame& frame) {
+    if (!file_) return;
+    u32 crc = crc32(reinterpret_cast<const u8*>(frame.pixels.data()), frame.pixels.size() * 4);
+    fprintf(file_, "%llu %u %u %08x\n", (unsigned long long)frame.number, frame.width, frame.height, crc);
+    std::fflush(file_);
+}
+
+RawSink::RawSink(const std::string& path) {
+    file_ = std::fopen(path.c_str(), "wb");
+    if (!file_) {
+        fprintf(stderr, "[VI] Failed to open raw video output %s\n", path.c_str());
+    }
+}
+
+RawSink::~RawSink() {
+    if (file_) {
+        std::fclose(file_);
+    }
+}
+
+void RawSink::consume(const CapturedFrame& frame) {
+    if (!file_) return;
+    if (frame.width != width_ || frame.height != height_) {
+        fprintf(stderr, "[VI] Raw video: frame %llu is %ux%u\n",
+                (unsigned long long)frame.number, frame.width, frame.height);
+        width_ = frame.width;
+        height_ = frame.height;
+    }
+    std::fwrite(frame.pixels.data(), 4, frame.pixels.size(), file_);
+}
+
+PngSink::PngSink(const std::string& directory, std::set<u64> frames)
+    : directory_(directory)
+    , frames_(std::move(frames))
+{
+}
+
+void PngSink::consume(const CapturedFrame& frame) {
+    if (!frames_.count(frame.number)) return;
+    char name[32];
+    snprintf(name, sizeof(name), "/frame_%06llu.png", (unsigned long long)frame.number);
+    if (write_png(directory_ + name, frame.pixels.data(), frame.width, frame.height)) {
+        fprintf(stderr, "[VI] Wrote %s%s\n", directory_.c_str(), name);
+    }
+}
+
+FrameDumper::FrameDumper() = default;
+
+FrameDumper::~FrameDumper() {
+    if (!thread_.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    work_ready_.notify_one();
+    thread_.join();
+}
+
+void FrameDumper::add_sink(std::unique_ptr<FrameSink> sink) {
+    sinks_.push_back(std::move(sink));
+    if (!thread_.joinable()) {
+        thread_ = std::thread(&FrameDumper::run, this);
+    }
+}
+
+void FrameDumper::submit(u64 number, const u32* pixels, u32 width, u32 height) {
+    if (sinks_.empty()) return;
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    space_ready_.wait(lock, [this] { return queue_.size() < MAX_QUEUED; });
+
+    std::vector<u32> buffer;
+    if (!free_buffers_.empty()) {
+        buffer = std::move(free_buffers_.back());
+        free_buffers_.pop_back();
+    }
+    buffer.assign(pixels, pixels + static_cast<size_t>(width) * height);
+    queue_.push_back({number, width, height, std::move(buffer)});
+    lock.unlock();
+    work_ready_.notify_one();
+}
+
+// Drains the queue before exiting so every submitted frame reaches the sinks
+void FrameDumper::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        work_ready_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+        if (queue_.empty()) break;
+
+        CapturedFrame frame = std::move(queue_.front());
+        queue_.pop_front();
+        lock.unlock();
+        space_ready_.notify_one();
+
+        for (auto& sink : sinks_) {
+            sink->consume(frame);
+        }
+
+        lock.lock();
+        free_buffers_.push_back(std::move(frame.pixels));
+    }
+}
+
+} // namespace n64::interfaces
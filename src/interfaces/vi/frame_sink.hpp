@@ -0,0 +1,101 @@
+#pragma once
+
+#include "../../utils/types.hpp"
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace n64::interfaces {
+
+// A displayed frame: RGBA32 pixels (bytes R, G, B, A)
+struct CapturedFrame {
+    u64 number;
+    u32 width;
+    u32 height;
+    std::vector<u32> pixels;
+};
+
+class FrameSink {
+public:
+    virtual ~FrameSink() = default;
+    virtual void consume(const CapturedFrame& frame) = 0;
+};
+
+// CRC-32 (IEEE) of the pixel bytes, one "frame width height crc" line per frame
+class HashSink : public FrameSink {
+public:
+    explicit HashSink(const std::string& path);
+    ~HashSink() override;
+    void consume(const CapturedFrame& frame) override;
+
+private:
+    std::FILE* file_;
+};
+
+// Raw RGBA frames back to back, for external encoders, e.g.
+// ffmpeg -f rawvideo -pix_fmt rgba -s 640x474 -r 60 -i <file> out.mp4
+// The path may be a named pipe.
+class RawSink : public FrameSink {
+public:
+    explicit RawSink(const std::string& path);
+    ~RawSink() override;
+    void consume(const CapturedFrame& frame) override;
+
+private:
+    std::FILE* file_;
+    u32 width_ = 0;
+    u32 height_ = 0;
+};
+
+// PNG snapshots of the chosen frame numbers, written as <dir>/frame_<n>.png
+class PngSink : public FrameSink {
+public:
+    PngSink(const std::string& directory, std::set<u64> frames);
+    void consume(const CapturedFrame& frame) override;
+
+private:
+    std::string directory_;
+    std::set<u64> frames_;
+};
+
+[[nodiscard]] u32 crc32(const u8* data, size_t length, u32 crc = 0);
+bool write_png(const std::string& path, const u32* pixels, u32 width, u32 height);
+
+// Hands frames to the sinks on a worker thread. Frames are copied on submit;
+// if the worker falls more than MAX_QUEUED frames behind, submit waits so that
+// no frame is lost.
+class FrameDumper {
+public:
+    static constexpr size_t MAX_QUEUED = 8;
+
+    FrameDumper();
+    ~FrameDumper();
+
+    FrameDumper(const FrameDumper&) = delete;
+    FrameDumper& operator=(const FrameDumper&) = delete;
+
+    void add_sink(std::unique_ptr<FrameSink> sink);
+    [[nodiscard]] bool active() const { return !sinks_.empty(); }
+
+    void submit(u64 number, const u32* pixels, u32 width, u32 height);
+
+private:
+    void run();
+
+    std::vector<std::unique_ptr<FrameSink>> sinks_;
+    std::deque<CapturedFrame> queue_;
+    std::vector<std::vector<u32>> free_buffers_;
+    std::mutex mutex_;
+    std::condition_variable work_ready_;
+    std::condition_variable space_ready_;
+    bool stopping_ = false;
+    std::thread thread_;
+};
+
+} // namespace n64::interfaces
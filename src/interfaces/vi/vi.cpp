@@ -170,6 +170,7 @@ void VI::process_passed_cycles(u32 cycles) {
         
         // Field wrap: toggle field bit for interlaced modes
         if (v_current_.v_current < old_v_current) {
+            fields_++;
             if (ctrl_.serrate) {
                 v_current_.v_current ^= 1;
             }
@@ -192,6 +193,51 @@ void VI::process_passed_cycles(u32 cycles) {
     }
 }
 
+void VI::save_state(StateWriter& writer) const
+{
+    writer.begin_chunk("VI  ", 1);
+    writer.write(cycles_counter_);
+    writer.write(ctrl_);
+    writer.write(origin_);
+    writer.write(width_);
+    writer.write(v_intr_);
+    writer.write(v_current_);
+    writer.write(burst_);
+    writer.write(v_total_);
+    writer.write(h_total_);
+    writer.write(h_total_leap_);
+    writer.write(h_video_);
+    writer.write(v_video_);
+    writer.write(v_burst_);
+    writer.write(x_scale_);
+    writer.write(y_scale_);
+    writer.write(test_addr_);
+    writer.write(staged_data_);
+    writer.end_chunk();
+}
+
+void VI::load_state(StateReader& reader)
+{
+    if (!reader.open_chunk("VI  ", 1)) return;
+    reader.read(cycles_counter_);
+    reader.read(ctrl_);
+    reader.read(origin_);
+    reader.read(width_);
+    reader.read(v_intr_);
+    reader.read(v_current_);
+    reader.read(burst_);
+    reader.read(v_total_);
+    reader.read(h_total_);
+    reader.read(h_total_leap_);
+    reader.read(h_video_);
+    reader.read(v_video_);
+    reader.read(v_burst_);
+    reader.read(x_scale_);
+    reader.read(y_scale_);
+    reader.read(test_addr_);
+    reader.read(staged_data_);
+}
+
 template u8 VI::read<u8>(u32) const;
 template u16 VI::read<u16>(u32) const;
 template u32 VI::read<u32>(u32) const;
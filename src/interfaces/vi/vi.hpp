@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../../utils/types.hpp"
+#include "../../utils/save_state.hpp"
 #include "../mi.hpp"
 #include "vi_registers.hpp"
 #include "vi_renderer.hpp"
@@ -29,15 +30,30 @@ public:
     [[nodiscard]] const VIOrigin& origin() const { return origin_; }
     [[nodiscard]] const VIWidth& width() const { return width_; }
     [[nodiscard]] const VIVCurrent& v_current() const { return v_current_; }
+    [[nodiscard]] const VIHVideo& h_video() const { return h_video_; }
+    [[nodiscard]] const VIVVideo& v_video() const { return v_video_; }
+    [[nodiscard]] const VIXScale& x_scale() const { return x_scale_; }
+    [[nodiscard]] const VIYScale& y_scale() const { return y_scale_; }
 
     void process_passed_cycles(u32 cycles);
     bool handle_events() { return renderer_.handle_events(); }
+    void present() { renderer_.present(); }
+    void stop_presenting() { renderer_.stop_presenting(); }
+    void keyboard_state(std::vector<u8>& keys) const { renderer_.keyboard_state(keys); }
+    // Reports scan-out reads of the framebuffer
+    void set_profiler(memory::AccessProfiler* profiler) { renderer_.set_profiler(profiler); }
     [[nodiscard]] u32 color_image_size() const { return (ctrl_.type == 3) ? 32 : 16; }
+    // Fields scanned out since power-on (host-side counter, not part of save states)
+    [[nodiscard]] u64 fields() const { return fields_; }
+
+    void save_state(StateWriter& writer) const;
+    void load_state(StateReader& reader);
 
 private:
     MI& mi_;
     VIRenderer renderer_;
     u64 cycles_counter_;
+    u64 fields_ = 0;
 
     VICtrl ctrl_;
     VIOrigin origin_;
@@ -0,0 +1,287 @@
+#include "vi_filters.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace n64::interfaces {
+
+namespace {
+
+inline u32 coverage(const u8* pixel) {
+    return pixel[3] >> 5;
+}
+
+// Copies the image so passes can read unfiltered neighbours while writing
+void snapshot(const FilterImage& image, std::vector<u32>& scratch) {
+    scratch.resize(static_cast<size_t>(image.stride) * image.height);
+    std::copy_n(image.pixels, scratch.size(), scratch.begin());
+}
+
+inline const u8* row_at(const std::vector<u32>& scratch, const FilterImage& image, s32 y) {
+    y = std::clamp<s32>(y, 0, image.height - 1);
+    return reinterpret_cast<const u8*>(&scratch[static_cast<size_t>(y) * image.stride]);
+}
+
+// Hash for gamma dither noise
+inline u32 noise(u32 x, u32 y, u32 seed) {
+    u32 h = x * 0x9E3779B1u ^ y * 0x85EBCA77u ^ seed * 0xC2B2AE3Du;
+    h ^= h >> 15;
+    h *= 0x2C1B3C6Du;
+    h ^= h >> 12;
+    return h;
+}
+
+// Median of (row[i - 4], row[i], row[i + 4]) where mask[i] is 0xFF, row[i] elsewhere
+void divot_span(const u8* row, const u8* mask, u8* out, u32 begin, u32 end) {
+    u32 i = begin;
+#if defined(__SSE2__)
+    for (; i + 16 <= end; i += 16) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i - 4));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i));
+        __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i + 4));
+        __m128i m = _mm_loadu_si128(reinterpret_cast<const __m128i*>(mask + i));
+        __m128i median = _mm_max_epu8(_mm_min_epu8(a, b), _mm_min_epu8(_mm_max_epu8(a, b), d));
+        __m128i result = _mm_or_si128(_mm_and_si128(m, median), _mm_andnot_si128(m, b));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), result);
+    }
+#endif
+    for (; i < end; i++) {
+        u8 a = row[i - 4];
+        u8 b = row[i];
+        u8 d = row[i + 4];
+        u8 median = std::max(std::min(a, b), std::min(std::max(a, b), d));
+        out[i] = mask[i] ? median : b;
+    }
+}
+
+// center[i] plus one for every 3x3 neighbour whose top five bits are above the
+// center's and minus one for every one below, where mask[i] is 0xFF. The h
+// rows hold top-five-bit values padded by one pixel on either side.
+void dedither_span(const u8* h0, const u8* h1, const u8* h2, const u8* center, const u8* mask, u8* out, u32 count) {
+    u32 i = 0;
+#if defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= count; i += 16) {
+        __m128i base = _mm_loadu_si128(reinterpret_cast<const __m128i*>(h1 + i + 4));
+        __m128i delta = zero;
+        for (const u8* h : {h0, h1, h2}) {
+            for (u32 o = 0; o <= 8; o += 4) {
+                __m128i n = _mm_loadu_si128(reinterpret_cast<const __m128i*>(h + i + o));
+                delta = _mm_sub_epi8(delta, _mm_cmpgt_epi8(n, base));
+                delta = _mm_add_epi8(delta, _mm_cmpgt_epi8(base, n));
+            }
+        }
+        delta = _mm_and_si128(delta, _mm_loadu_si128(reinterpret_cast<const __m128i*>(mask + i)));
+        __m128i up = _mm_and_si128(delta, _mm_cmpgt_epi8(delta, zero));
+        __m128i down = _mm_and_si128(_mm_sub_epi8(zero, delta), _mm_cmpgt_epi8(zero, delta));
+        __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(center + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_subs_epu8(_mm_adds_epu8(c, up), down));
+    }
+#endif
+    for (; i < count; i++) {
+        s32 base = h1[i + 4];
+        s32 delta = 0;
+        for (const u8* h : {h0, h1, h2}) {
+            for (u32 o = 0; o <= 8; o += 4) {
+                delta += (h[i + o] > base) - (h[i + o] < base);
+            }
+        }
+        out[i] = std::clamp<s32>(center[i] + (mask[i] ? delta : 0), 0, 255);
+    }
+}
+
+// Blends the pixel at x toward the average of its fully covered neighbours
+inline void antialias_pixel(const u8* above, const u8* center, const u8* below, u8* out, u32 x, u32 width) {
+    u32 i = x * 4;
+    u32 cvg = coverage(&center[i]);
+    if (cvg == 7) return;
+
+    u32 left = (x > 0) ? i - 4 : i;
+    u32 right = (x + 1 < width) ? i + 4 : i;
+    const u8* neighbours[4] = {&center[left], &center[right], &above[i], &below[i]};
+
+    u32 sum[3] = {0, 0, 0};
+    u32 count = 0;
+    for (const u8* n : neighbours) {
+        u32 full = coverage(n) == 7;
+        for (u32 c = 0; c < 3; c++) sum[c] += n[c] * full;
+        count += full;
+    }
+    if (count == 0) return;
+
+    for (u32 c = 0; c < 3; c++) {
+        s32 background = sum[c] / count;
+        out[i + c] = center[i + c] + ((background - center[i + c]) * static_cast<s32>(7 - cvg)) / 8;
+    }
+}
+
+#if defined(__SSE2__)
+// Two pixels of antialias_pixel as 16-bit channels. Neighbours count where
+// their coverage is 7, the sum is divided by the count with shifts and a
+// multiply by 1/3, and the result is kept only on color channels of pixels
+// with partial coverage and at least one full neighbour.
+inline __m128i antialias_x2(__m128i c, __m128i l, __m128i r, __m128i a, __m128i b) {
+    const __m128i seven = _mm_set1_epi16(7);
+    const __m128i one = _mm_set1_epi16(1);
+    const __m128i two = _mm_set1_epi16(2);
+    const __m128i three = _mm_set1_epi16(3);
+    const __m128i third = _mm_set1_epi16(static_cast<short>(0xAAAB));
+    const __m128i color = _mm_set_epi16(0, -1, -1, -1, 0, -1, -1, -1);
+    auto cvg = [](__m128i p) {
+        return _mm_srli_epi16(_mm_shufflehi_epi16(_mm_shufflelo_epi16(p, 0xFF), 0xFF), 5);
+    };
+
+    __m128i sum = _mm_setzero_si128();
+    __m128i count = _mm_setzero_si128();
+    for (__m128i n : {l, r, a, b}) {
+        __m128i full = _mm_cmpeq_epi16(cvg(n), seven);
+        sum = _mm_add_epi16(sum, _mm_and_si128(n, full));
+        count = _mm_sub_epi16(count, full);
+    }
+
+    __m128i background = sum;
+    auto select = [&background](__m128i mask, __m128i value) {
+        background = _mm_or_si128(_mm_and_si128(mask, value), _mm_andnot_si128(mask, background));
+    };
+    select(_mm_cmpeq_epi16(count, two), _mm_srli_epi16(sum, 1));
+    select(_mm_cmpeq_epi16(count, three), _mm_srli_epi16(_mm_mulhi_epu16(sum, third), 1));
+    select(_mm_cmpgt_epi16(count, three), _mm_srli_epi16(sum, 2));
+
+    // (background - c) * (7 - cvg) / 8, rounded toward zero
+    __m128i center_cvg = cvg(c);
+    __m128i blend = _mm_mullo_epi16(_mm_sub_epi16(background, c), _mm_sub_epi16(seven, center_cvg));
+    blend = _mm_srai_epi16(_mm_add_epi16(blend, _mm_and_si128(_mm_srai_epi16(blend, 15), seven)), 3);
+
+    __m128i keep = _mm_or_si128(_mm_cmpeq_epi16(center_cvg, seven), _mm_cmplt_epi16(count, one));
+    __m128i update = _mm_andnot_si128(keep, color);
+    return _mm_add_epi16(c, _mm_and_si128(blend, update));
+}
+
+// antialias_pixel on pixels x to x + 3, which must have neighbours on both sides
+inline void antialias_x4(const u8* above, const u8* center, const u8* below, u8* out, u32 x) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i full = _mm_set1_epi32(7);
+    u32 i = x * 4;
+    __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(center + i));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_srli_epi32(c, 29), full)) == 0xFFFF) return;
+
+    __m128i l = _mm_loadu_si128(reinterpret_cast<const __m128i*>(center + i - 4));
+    __m128i r = _mm_loadu_si128(reinterpret_cast<const __m128i*>(center + i + 4));
+    __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(above + i));
+    __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(below + i));
+    __m128i lo = antialias_x2(_mm_unpacklo_epi8(c, zero), _mm_unpacklo_epi8(l, zero), _mm_unpacklo_epi8(r, zero),
+                              _mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+    __m128i hi = antialias_x2(_mm_unpackhi_epi8(c, zero), _mm_unpackhi_epi8(l, zero), _mm_unpackhi_epi8(r, zero),
+                              _mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packus_epi16(lo, hi));
+}
+#endif
+
+} // namespace
+
+void filter_antialias(FilterImage& image, std::vector<u32>& scratch) {
+    snapshot(image, scratch);
+    for (u32 y = 0; y < image.height; y++) {
+        const u8* above = row_at(scratch, image, y - 1);
+        const u8* center = row_at(scratch, image, y);
+        const u8* below = row_at(scratch, image, y + 1);
+        u8* out = reinterpret_cast<u8*>(&image.pixels[static_cast<size_t>(y) * image.stride]);
+
+        // The first and last pixels repeat themselves as their missing neighbour
+        u32 x = 0;
+        if (image.width > 0) antialias_pixel(above, center, below, out, x++, image.width);
+#if defined(__SSE2__)
+        for (; x + 4 < image.width; x += 4) antialias_x4(above, center, below, out, x);
+#endif
+        for (; x < image.width; x++) antialias_pixel(above, center, below, out, x, image.width);
+    }
+}
+
+void filter_divot(FilterImage& image, std::vector<u32>& scratch) {
+    if (image.width < 3) return;
+    snapshot(image, scratch);
+    u32 row_bytes = image.width * 4;
+    std::vector<u8> near_edge(row_bytes);
+
+    for (u32 y = 0; y < image.height; y++) {
+        const u8* row = row_at(scratch, image, y);
+        u8* out = reinterpret_cast<u8*>(&image.pixels[static_cast<size_t>(y) * image.stride]);
+
+        // Every byte of a pixel that has a partially covered pixel within one
+        // column of it (alpha bytes are restored below)
+        for (u32 x = 0; x < image.width; x++) {
+            u32 left = (x > 0) ? x - 1 : x;
+            u32 right = (x + 1 < image.width) ? x + 1 : x;
+            u8 flag = (coverage(&row[left * 4]) != 7 || coverage(&row[x * 4]) != 7 || coverage(&row[right * 4]) != 7) ? 0xFF : 0;
+            near_edge[x * 4 + 0] = near_edge[x * 4 + 1] = near_edge[x * 4 + 2] = flag;
+            near_edge[x * 4 + 3] = 0;
+        }
+
+        divot_span(row, near_edge.data(), out, 4, row_bytes - 4);
+    }
+}
+
+void filter_dedither(FilterImage& image, std::vector<u32>& scratch) {
+    snapshot(image, scratch);
+    u32 row_bytes = image.width * 4;
+
+    // Top five bits of each row's bytes, padded by one pixel on either side
+    // with the edge pixel repeated, so the 3x3 loop below has no edge checks
+    std::vector<u8> high[3];
+    for (auto& h : high) h.resize(row_bytes + 8);
+    std::vector<u8> full(row_bytes);
+
+    for (u32 y = 0; y < image.height; y++) {
+        const u8* rows[3] = {row_at(scratch, image, y - 1), row_at(scratch, image, y), row_at(scratch, image, y + 1)};
+        for (u32 k = 0; k < 3; k++) {
+            u8* h = high[k].data();
+            for (u32 i = 0; i < row_bytes; i++) h[i + 4] = rows[k][i] >> 3;
+            for (u32 c = 0; c < 4; c++) {
+                h[c] = h[c + 4];
+                h[row_bytes + 4 + c] = h[row_bytes + c];
+            }
+        }
+        const u8* center = rows[1];
+        for (u32 x = 0; x < image.width; x++) {
+            u8 flag = (coverage(&center[x * 4]) == 7) ? 0xFF : 0;
+            full[x * 4 + 0] = full[x * 4 + 1] = full[x * 4 + 2] = flag;
+            full[x * 4 + 3] = 0;
+        }
+
+        u8* out = reinterpret_cast<u8*>(&image.pixels[static_cast<size_t>(y) * image.stride]);
+        dedither_span(high[0].data(), high[1].data(), high[2].data(), center, full.data(), out, row_bytes);
+    }
+}
+
+void filter_gamma(u32* pixels, u32 width, u32 height, bool gamma, bool dither, u32 seed) {
+    // sqrt over a 14-bit input (8-bit color with 6 dither bits below it)
+    static const std::array<u8, 1 << 14> table = [] {
+        std::array<u8, 1 << 14> t{};
+        for (u32 i = 0; i < t.size(); i++) {
+            t[i] = static_cast<u8>(std::lround(std::sqrt(i / 16383.0) * 255.0));
+        }
+        return t;
+    }();
+
+    for (u32 y = 0; y < height; y++) {
+        u8* row = reinterpret_cast<u8*>(&pixels[static_cast<size_t>(y) * width]);
+        for (u32 x = 0; x < width; x++) {
+            u32 bits = dither ? noise(x, y, seed) : 0;
+            for (u32 c = 0; c < 3; c++) {
+                u8& value = row[x * 4 + c];
+                if (gamma) {
+                    value = table[(value << 6) | ((bits >> (c * 6)) & 0x3F)];
+                } else {
+                    value = std::min<u32>(255, value + ((bits >> c) & 1));
+                }
+            }
+        }
+    }
+}
+
+} // namespace n64::interfaces
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "../../utils/types.hpp"
+#include <vector>
+
+namespace n64::interfaces {
+
+// VI filter passes. The framebuffer passes (AA, divot, dedither) run on
+// scanned-out source lines before resampling and read each pixel's coverage
+// from the top three bits of its alpha byte (see vi_scanout.hpp). Gamma runs
+// on the resampled output. The passes are written as straight loops over
+// whole rows with no per-pixel branches on data where possible, so the
+// compiler can vectorize them.
+
+// Rows of RGBA32 pixels, stride apart
+struct FilterImage {
+    u32* pixels;
+    u32 width;
+    u32 height;
+    u32 stride;
+};
+
+// Blends edge pixels (coverage < 7) toward the average of their fully covered
+// neighbours, weighted by the missing coverage
+void filter_antialias(FilterImage& image, std::vector<u32>& scratch);
+
+// Median of three horizontally around pixels next to a partially covered one
+void filter_divot(FilterImage& image, std::vector<u32>& scratch);
+
+// Rebuilds the bits lost to dithering in fully covered pixels: every 3x3
+// neighbour whose 5-bit value is above (below) the center's adds (subtracts) one
+void filter_dedither(FilterImage& image, std::vector<u32>& scratch);
+
+// Square-root gamma on the output. Gamma dither adds 6 bits of noise below
+// the 8-bit value first (or one LSB without gamma), seeded per frame so the
+// output stays reproducible.
+void filter_gamma(u32* pixels, u32 width, u32 height, bool gamma, bool dither, u32 seed);
+
+} // namespace n64::interfaces
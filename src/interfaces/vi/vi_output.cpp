@@ -0,0 +1,191 @@
+#include "vi_output.hpp"
+#include "vi.hpp"
+#include "vi_filters.hpp"
+#include "vi_scanout.hpp"
+#include "../../memory/rdram.hpp"
+#include "../../memory/access_profiler.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+namespace n64::interfaces {
+
+VIOutput::~VIOutput() {
+    static constexpr const char* pass_names[PASS_COUNT] = {"aa", "divot", "dedither", "gamma"};
+    for (u32 pass = 0; pass < PASS_COUNT; pass++) {
+        const PassTiming& timing = timings_[pass];
+        if (timing.frames == 0) continue;
+        fprintf(stderr, "[VI] filter %-8s %llu frames, avg %.1f us, max %.1f us\n", pass_names[pass],
+                (unsigned long long)timing.frames, timing.total_ns / 1000.0 / timing.frames, timing.max_ns / 1000.0);
+    }
+}
+
+bool VIOutput::render(const VI& vi, const memory::RDRAM& rdram) {
+    u32 type = vi.ctrl().type;
+    u32 source_width = vi.width().width;
+    u32 origin = vi.origin().origin;
+
+    // Type 0 is blank, type 1 is reserved on real hardware
+    if (type < 2 || source_width == 0) {
+        return false;
+    }
+
+    const VIHVideo& h_video = vi.h_video();
+    const VIVVideo& v_video = vi.v_video();
+    const VIXScale& x_scale = vi.x_scale();
+    const VIYScale& y_scale = vi.y_scale();
+    if (h_video.h_end <= h_video.h_start || v_video.v_end <= v_video.v_start + 1
+        || x_scale.x_scale == 0 || y_scale.y_scale == 0) {
+        render_direct(rdram, origin, type, source_width);
+        return true;
+    }
+
+    Geometry geometry{};
+    geometry.width = h_video.h_end - h_video.h_start;
+    geometry.field_lines = (v_video.v_end - v_video.v_start) / 2;
+    geometry.interlaced = vi.ctrl().serrate;
+    geometry.x_scale = x_scale.x_scale;
+    geometry.x_offset = x_scale.x_offset;
+    geometry.y_scale = y_scale.y_scale;
+    geometry.y_offset = y_scale.y_offset;
+    geometry.source_width = source_width;
+    geometry.filtered = vi.ctrl().aa_mode != 3;
+    set_geometry(geometry);
+
+    // Scan out every line the field samples, plus the lower tap of the last one
+    u32 bytes_per_pixel = (type == 3) ? 4 : 2;
+    u32 stride = source_width + 1;
+    source_first_ = geometry.y_offset >> 10;
+    u32 source_last = (geometry.y_offset + (geometry.field_lines - 1) * geometry.y_scale) >> 10;
+    source_lines_ = source_last - source_first_ + 2;
+    source_.resize(static_cast<size_t>(stride) * source_lines_);
+    for (u32 line = 0; line < source_lines_; line++) {
+        u32* row = &source_[static_cast<size_t>(line) * stride];
+        u32 addr = origin + (source_first_ + line) * source_width * bytes_per_pixel;
+        scan_out_row(rdram, addr, type, row, source_width);
+        row[source_width] = row[source_width - 1];
+    }
+    if (profiler_) {
+        profiler_->record_dma(memory::AccessProfiler::Dma::VI,
+                              origin + source_first_ * source_width * bytes_per_pixel,
+                              source_lines_ * source_width * bytes_per_pixel, false);
+    }
+
+    if (filters_enabled_) {
+        apply_source_filters(vi);
+    }
+
+    // In interlaced modes bit 0 of V_CURRENT is the field being displayed
+    u32 field = geometry.interlaced ? (vi.v_current().v_current & 1) : 0;
+    u32 row_bytes = stride * 4;
+
+    for (u32 y = 0; y < geometry.field_lines; y++) {
+        u32 y_pos = geometry.y_offset + y * geometry.y_scale;
+        u32 line = (y_pos >> 10) - source_first_;
+        u32 y_frac = geometry.filtered ? (y_pos >> 5) & 0x1F : 0;
+
+        const u32* row = &source_[static_cast<size_t>(line) * stride];
+        if (y_frac != 0) {
+            const u8* top = reinterpret_cast<const u8*>(row);
+            const u8* bottom = top + row_bytes;
+            u8* blended = reinterpret_cast<u8*>(blended_.data());
+            for (u32 i = 0; i < row_bytes; i++) {
+                blended[i] = top[i] + (((bottom[i] - top[i]) * static_cast<s32>(y_frac)) >> 5);
+            }
+            row = blended_.data();
+        }
+
+        u32 out_line = geometry.interlaced ? y * 2 + field : y;
+        u8* out = reinterpret_cast<u8*>(&frame_[out_line * width_]);
+        for (u32 x = 0; x < width_; x++, out += 4) {
+            const u8* left = reinterpret_cast<const u8*>(&row[column_x_[x]]);
+            const u8* right = left + 4;
+            s32 x_frac = column_frac_[x];
+            for (u32 c = 0; c < 3; c++) {
+                out[c] = left[c] + (((right[c] - left[c]) * x_frac) >> 5);
+            }
+            out[3] = 0xFF;
+        }
+    }
+
+    const VICtrl& ctrl = vi.ctrl();
+    if (filters_enabled_ && (ctrl.gamma_enable || ctrl.gamma_dither_enable)) {
+        timed(PASS_GAMMA, [&] {
+            filter_gamma(frame_.data(), width_, height_, ctrl.gamma_enable, ctrl.gamma_dither_enable, field_count_);
+        });
+    }
+    field_count_++;
+    return true;
+}
+
+// AA modes 0-1 run the edge filter; divot and dedither have their own bits.
+// Dedither only makes sense on top of AA, as on hardware.
+void VIOutput::apply_source_filters(const VI& vi) {
+    const VICtrl& ctrl = vi.ctrl();
+    bool antialias = ctrl.aa_mode < 2;
+    if (!antialias && !ctrl.divot_enable) return;
+
+    FilterImage image{source_.data(), geometry_.source_width, source_lines_, geometry_.source_width + 1};
+    if (antialias) {
+        timed(PASS_AA, [&] { filter_antialias(image, scratch_); });
+    }
+    if (ctrl.divot_enable) {
+        timed(PASS_DIVOT, [&] { filter_divot(image, scratch_); });
+    }
+    if (antialias && ctrl.dedither_filter_enable) {
+        timed(PASS_DEDITHER, [&] { filter_dedither(image, scratch_); });
+    }
+}
+
+template<typename Pass>
+void VIOutput::timed(FilterPass pass, Pass&& run) {
+    auto start = std::chrono::steady_clock::now();
+    run();
+    u64 elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+    PassTiming& timing = timings_[pass];
+    timing.max_ns = std::max(timing.max_ns, elapsed);
+    timing.total_ns += elapsed;
+    timing.frames++;
+}
+
+void VIOutput::set_geometry(const Geometry& geometry) {
+    if (geometry == geometry_) return;
+
+    geometry_ = geometry;
+    width_ = geometry.width;
+    height_ = geometry.field_lines * (geometry.interlaced ? 2 : 1);
+    frame_.assign(static_cast<size_t>(width_) * height_, 0xFF000000u);
+
+    column_x_.resize(width_);
+    column_frac_.resize(width_);
+    for (u32 x = 0; x < width_; x++) {
+        u32 x_pos = geometry.x_offset + x * geometry.x_scale;
+        column_x_[x] = std::min(x_pos >> 10, geometry.source_width - 1);
+        column_frac_[x] = geometry.filtered ? (x_pos >> 5) & 0x1F : 0;
+    }
+    blended_.resize(geometry.source_width + 1);
+}
+
+void VIOutput::render_direct(const memory::RDRAM& rdram, u32 origin, u32 type, u32 source_width) {
+    geometry_ = Geometry{};
+    width_ = source_width;
+    height_ = source_width * 3 / 4;
+    frame_.resize(static_cast<size_t>(width_) * height_);
+
+    u32 bytes_per_pixel = (type == 3) ? 4 : 2;
+    for (u32 y = 0; y < height_; y++) {
+        u32* row = &frame_[y * width_];
+        scan_out_row(rdram, origin + y * width_ * bytes_per_pixel, type, row, width_);
+        // The alpha byte holds coverage; the output is opaque
+        for (u32 x = 0; x < width_; x++) {
+            reinterpret_cast<u8*>(&row[x])[3] = 0xFF;
+        }
+    }
+    if (profiler_) {
+        profiler_->record_dma(memory::AccessProfiler::Dma::VI, origin, height_ * width_ * bytes_per_pixel, false);
+    }
+}
+
+} // namespace n64::interfaces
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "../../utils/types.hpp"
+#include <array>
+#include <vector>
+
+namespace n64::memory {
+class RDRAM;
+class AccessProfiler;
+}
+
+namespace n64::interfaces {
+
+class VI;
+
+// VI output stage: turns the framebuffer into the picture the VI would put on
+// screen. The active area comes from H_VIDEO (screen pixels) and V_VIDEO
+// (half-lines), and every output pixel samples the framebuffer at
+// offset + index * scale using the 2.10 X_SCALE/Y_SCALE registers.
+//
+// Only the framebuffer lines the field samples are scanned out. The VI_CTRL
+// filters (AA, divot, dedither, see vi_filters.hpp) run on those lines, which
+// are then resampled: each output line blends its two source lines
+// vertically, and the blended row is resampled horizontally through
+// per-column tables. Gamma runs last on the output. With serrate set each
+// field fills every other line of a frame twice as tall.
+//
+// If the timing registers are not programmed, the framebuffer is shown 1:1
+// at width x width * 3 / 4 without filtering.
+class VIOutput {
+public:
+    ~VIOutput();
+
+    // Renders the current field. Returns false when the VI is blanked.
+    bool render(const VI& vi, const memory::RDRAM& rdram);
+
+    // Headless runs skip the filter pipeline
+    void set_filters_enabled(bool enabled) { filters_enabled_ = enabled; }
+    // Reports the framebuffer lines each field scans out
+    void set_profiler(memory::AccessProfiler* profiler) { profiler_ = profiler; }
+
+    // Output frame, RGBA8888 as bytes R, G, B, A
+    [[nodiscard]] const std::vector<u32>& frame() const { return frame_; }
+    [[nodiscard]] u32 width() const { return width_; }
+    [[nodiscard]] u32 height() const { return height_; }
+
+private:
+    struct Geometry {
+        u32 width;          // output pixels per line
+        u32 field_lines;    // output lines per field
+        bool interlaced;
+        u32 x_scale;        // 2.10
+        u32 x_offset;       // 2.10
+        u32 y_scale;        // 2.10
+        u32 y_offset;       // 0.10
+        u32 source_width;   // VI_WIDTH
+        bool filtered;      // bilinear, otherwise nearest (AA mode 3)
+
+        bool operator==(const Geometry&) const = default;
+    };
+
+    enum FilterPass { PASS_AA, PASS_DIVOT, PASS_DEDITHER, PASS_GAMMA, PASS_COUNT };
+
+    struct PassTiming {
+        u64 max_ns = 0;
+        u64 total_ns = 0;
+        u64 frames = 0;
+    };
+
+    void set_geometry(const Geometry& geometry);
+    void render_direct(const memory::RDRAM& rdram, u32 origin, u32 type, u32 source_width);
+    void apply_source_filters(const VI& vi);
+
+    template<typename Pass>
+    void timed(FilterPass pass, Pass&& run);
+
+    Geometry geometry_{};
+    memory::AccessProfiler* profiler_ = nullptr;
+    std::vector<u32> frame_;
+    u32 width_ = 0;
+    u32 height_ = 0;
+    u32 field_count_ = 0;
+
+    // Horizontal tables: left source pixel and 5-bit blend weight per column
+    std::vector<u32> column_x_;
+    std::vector<u8> column_frac_;
+
+    // Scanned-out framebuffer lines [source_first_, source_first_ + source_lines_),
+    // each with one extra pixel so the right-hand tap of the last column stays in the row
+    std::vector<u32> source_;
+    u32 source_first_ = 0;
+    u32 source_lines_ = 0;
+    std::vector<u32> blended_;
+    std::vector<u32> scratch_;
+
+    bool filters_enabled_ = true;
+    std::array<PassTiming, PASS_COUNT> timings_{};
+};
+
+} // namespace n64::interfaces
@@ -0,0 +1,144 @@
+#include "vi_presenter.hpp"
+#include <algorithm>
+#include <cstdio>
+
+namespace n64::interfaces {
+
+VIPresenter::VIPresenter(SDL_Window* window, Mode mode)
+    : window_(window)
+    , mode_(mode)
+{
+    renderer_ = SDL_CreateRenderer(window_, nullptr);
+    vsync_ = renderer_ && SDL_SetRenderVSync(renderer_, 1);
+}
+
+VIPresenter::~VIPresenter() {
+    if (texture_) SDL_DestroyTexture(texture_);
+    if (renderer_) SDL_DestroyRenderer(renderer_);
+
+    fprintf(stderr, "[VI] Frames: %llu submitted, %llu presented, %llu dropped, %llu duplicated\n",
+            (unsigned long long)submitted_,
+            (unsigned long long)presented_,
+            (unsigned long long)dropped_,
+            (unsigned long long)duplicated_);
+}
+
+void VIPresenter::submit(const u32* pixels, u32 width, u32 height) {
+    Frame& frame = frames_[back_];
+    frame.pixels.resize(static_cast<size_t>(width) * height);
+    std::copy_n(pixels, frame.pixels.size(), frame.pixels.begin());
+    frame.width = width;
+    frame.height = height;
+    frame.number = ++submitted_;
+
+    // Keep a pending stop request while swapping the buffer in
+    u32 previous = shared_.load(std::memory_order_relaxed);
+    while (!shared_.compare_exchange_weak(previous, back_ | NEW_FRAME | (previous & STOP),
+                                          std::memory_order_acq_rel)) {
+    }
+    back_ = previous & INDEX_MASK;
+}
+
+void VIPresenter::stop() {
+    shared_.fetch_or(STOP, std::memory_order_release);
+}
+
+void VIPresenter::keyboard_state(std::vector<u8>& keys) const {
+    std::lock_guard<std::mutex> lock(keys_mutex_);
+    keys = keys_;
+}
+
+void VIPresenter::pump_events() {
+    SDL_Event event;
+    while (SDL_PollEvent(&event)) {
+        if (event.type == SDL_EVENT_QUIT) {
+            closed_.store(true, std::memory_order_release);
+        }
+    }
+
+    int count = 0;
+    const bool* keys = SDL_GetKeyboardState(&count);
+    std::lock_guard<std::mutex> lock(keys_mutex_);
+    keys_.assign(keys, keys + count);
+}
+
+// One pass per host refresh. With vsync the present call does the waiting;
+// otherwise, and on passes with nothing to present, the loop sleeps until
+// the next refresh is due.
+void VIPresenter::run() {
+    const SDL_DisplayMode* display = SDL_GetCurrentDisplayMode(SDL_GetDisplayForWindow(window_));
+    float refresh_rate = (display && display->refresh_rate > 0.0f) ? display->refresh_rate : 60.0f;
+    const u64 refresh_ns = static_cast<u64>(SDL_NS_PER_SECOND / refresh_rate);
+    u64 next_refresh = SDL_GetTicksNS();
+    bool shown_any = false;
+
+    while (true) {
+        pump_events();
+        if (window_closed()) break;
+
+        u32 state = shared_.load(std::memory_order_acquire);
+        if (state & STOP) break;
+
+        bool new_frame = false;
+        if (state & NEW_FRAME) {
+            // A failed exchange means a newer frame or a stop request came in
+            if (!shared_.compare_exchange_weak(state, front_, std::memory_order_acq_rel)) continue;
+            front_ = state & INDEX_MASK;
+            new_frame = true;
+
+            // Everything submitted since the last refresh but this frame
+            const Frame& frame = frames_[front_];
+            dropped_ += frame.number - last_number_ - 1;
+            last_number_ = frame.number;
+        }
+
+        bool show = new_frame || (mode_ == Mode::Duplicate && shown_any);
+        if (show) {
+            if (!new_frame) duplicated_++;
+            present(frames_[front_]);
+            presented_++;
+            shown_any = true;
+        }
+
+        u64 now = SDL_GetTicksNS();
+        if (show && vsync_) {
+            next_refresh = now + refresh_ns;
+            continue;
+        }
+        next_refresh += refresh_ns;
+        if (next_refresh > now) {
+            SDL_DelayNS(next_refresh - now);
+        } else {
+            next_refresh = now;  // fell behind; don't try to catch up
+        }
+    }
+}
+
+void VIPresenter::present(const Frame& frame) {
+    if (frame.width == 0 || frame.height == 0) {
+        // Blank screen
+        SDL_SetRenderDrawColor(renderer_, 0, 0, 0, 255);
+        SDL_RenderClear(renderer_);
+        SDL_RenderPresent(renderer_);
+        return;
+    }
+
+    // Recreate texture if dimensions changed
+    if (frame.width != texture_width_ || frame.height != texture_height_) {
+        if (texture_) SDL_DestroyTexture(texture_);
+        texture_ = SDL_CreateTexture(renderer_, SDL_PIXELFORMAT_RGBA32,
+                                     SDL_TEXTUREACCESS_STREAMING, frame.width, frame.height);
+        texture_width_ = frame.width;
+        texture_height_ = frame.height;
+    }
+
+    // Update texture with the frame (stride = width * 4 bytes per pixel)
+    SDL_UpdateTexture(texture_, nullptr, frame.pixels.data(), frame.width * sizeof(u32));
+
+    // Render - SDL stretches texture to fill the window
+    SDL_RenderClear(renderer_);
+    SDL_RenderTexture(renderer_, texture_, nullptr, nullptr);
+    SDL_RenderPresent(renderer_);
+}
+
+} // namespace n64::interfaces
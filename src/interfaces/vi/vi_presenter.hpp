@@ -0,0 +1,89 @@
+#pragma once
+
+#include "../../utils/types.hpp"
+#include <SDL3/SDL.h>
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace n64::interfaces {
+
+// Shows finished frames without making the emulation wait on the display.
+// SDL only allows its renderer and event queue on the main thread, so run()
+// owns the main thread while emulation runs on a worker. Frames go through
+// three buffers: the emulation thread fills the back buffer and swaps it
+// with the shared slot, and the presenter swaps the shared slot with its
+// front buffer when a new frame is flagged. Each side only ever touches its
+// own buffer, and the handoff is a single atomic exchange.
+//
+// The presenter wakes once per host refresh (vsync when the renderer has
+// it) and takes the newest frame. Frames submitted since the last refresh
+// other than that one are dropped. When no new frame has arrived, the mode
+// decides:
+//   Drop:      nothing is presented until the next refresh (default)
+//   Duplicate: the last frame is shown again
+class VIPresenter {
+public:
+    enum class Mode { Drop, Duplicate };
+
+    // Creates the renderer; must be called on the main thread
+    VIPresenter(SDL_Window* window, Mode mode);
+    ~VIPresenter();
+
+    VIPresenter(const VIPresenter&) = delete;
+    VIPresenter& operator=(const VIPresenter&) = delete;
+
+    // Main thread: presents and pumps events until the window is closed or
+    // stop() is called
+    void run();
+
+    // Emulation thread
+    // Copies a finished RGBA32 frame into the back buffer and publishes it.
+    // A zero-sized frame clears the screen. Never blocks.
+    void submit(const u32* pixels, u32 width, u32 height);
+    void stop();
+    [[nodiscard]] bool window_closed() const { return closed_.load(std::memory_order_acquire); }
+    // Host keyboard as of the last event pump, indexed by SDL scancode
+    void keyboard_state(std::vector<u8>& keys) const;
+
+private:
+    struct Frame {
+        std::vector<u32> pixels;
+        u32 width = 0;
+        u32 height = 0;
+        u64 number = 0;  // submission count, for counting drops
+    };
+
+    static constexpr u32 INDEX_MASK = 0x3;
+    static constexpr u32 NEW_FRAME = 0x4;
+    static constexpr u32 STOP = 0x8;
+
+    void pump_events();
+    void present(const Frame& frame);
+
+    SDL_Window* window_;
+    SDL_Renderer* renderer_ = nullptr;
+    SDL_Texture* texture_ = nullptr;
+    u32 texture_width_ = 0;
+    u32 texture_height_ = 0;
+    Mode mode_;
+
+    std::array<Frame, 3> frames_;
+    u32 back_ = 0;                  // owned by the emulation thread
+    std::atomic<u32> shared_{1};    // index of the handoff buffer + flags
+    u32 front_ = 2;                 // owned by the presenter
+
+    std::atomic<bool> closed_{false};
+    mutable std::mutex keys_mutex_;
+    std::vector<u8> keys_;
+
+    u64 submitted_ = 0;   // emulation thread
+    u64 last_number_ = 0; // number of the last frame taken
+    bool vsync_ = false;
+    u64 presented_ = 0;
+    u64 dropped_ = 0;
+    u64 duplicated_ = 0;
+};
+
+} // namespace n64::interfaces
@@ -1,6 +1,11 @@
 #include "vi_renderer.hpp"
 #include "vi.hpp"
+#include "vi_output.hpp"
 #include "../../memory/rdram.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
 
 namespace n64::interfaces {
 
@@ -8,107 +13,105 @@ VIRenderer::VIRenderer(VI* vi, memory::RDRAM& rdram)
     : vi_(vi)
     , rdram_(rdram)
     , window_(nullptr)
-    , renderer_(nullptr)
-    , texture_(nullptr)
-    , texture_width_(0)
-    , texture_height_(0)
 {
+    setup_frame_dump();
+
+    // VI_HEADLESS=1 runs without a window and skips the VI filters
+    if (const char* env = std::getenv("VI_HEADLESS")) {
+        if (std::strcmp(env, "0") != 0) {
+            output_.set_filters_enabled(false);
+            return;
+        }
+    }
+
     SDL_Init(SDL_INIT_VIDEO);
     window_ = SDL_CreateWindow("N64 Emulator", 1280, 960, 0);  // 2x scale
-    renderer_ = SDL_CreateRenderer(window_, nullptr);
+
+    // VI_PRESENT=duplicate repeats the last frame at the host refresh rate
+    // instead of waiting for the next one
+    VIPresenter::Mode mode = VIPresenter::Mode::Drop;
+    if (const char* env = std::getenv("VI_PRESENT")) {
+        if (std::strcmp(env, "duplicate") == 0) {
+            mode = VIPresenter::Mode::Duplicate;
+        }
+    }
+    presenter_ = std::make_unique<VIPresenter>(window_, mode);
+}
+
+// VI_HASH=<file|->     CRC of every displayed frame, for regression runs
+// VI_RAW=<file|fifo>   raw RGBA frames for an external encoder
+// VI_PNG_DIR=<dir>     PNG snapshots of the frames listed in VI_PNG_FRAMES=n,n,...
+// VI_EXIT_FRAME=<n>    stop after n frames
+void VIRenderer::setup_frame_dump() {
+    if (const char* path = std::getenv("VI_HASH")) {
+        dumper_.add_sink(std::make_unique<HashSink>(path));
+    }
+    if (const char* path = std::getenv("VI_RAW")) {
+        dumper_.add_sink(std::make_unique<RawSink>(path));
+    }
+    if (const char* directory = std::getenv("VI_PNG_DIR")) {
+        std::set<u64> frames;
+        if (const char* list = std::getenv("VI_PNG_FRAMES")) {
+            std::stringstream stream(list);
+            std::string item;
+            while (std::getline(stream, item, ',')) {
+                if (!item.empty()) frames.insert(std::strtoull(item.c_str(), nullptr, 10));
+            }
+        }
+        if (frames.empty()) {
+            fprintf(stderr, "[VI] VI_PNG_DIR set without VI_PNG_FRAMES, no snapshots will be written\n");
+        } else {
+            dumper_.add_sink(std::make_unique<PngSink>(directory, std::move(frames)));
+        }
+    }
+    if (const char* env = std::getenv("VI_EXIT_FRAME")) {
+        exit_frame_ = std::strtoull(env, nullptr, 10);
+    }
 }
 
 VIRenderer::~VIRenderer() {
-    if (texture_) SDL_DestroyTexture(texture_);
-    if (renderer_) SDL_DestroyRenderer(renderer_);
+    presenter_.reset();
     if (window_) SDL_DestroyWindow(window_);
 }
 
+// Events are pumped by the presenter on the main thread
 bool VIRenderer::handle_events() {
-    SDL_Event event;
-    while (SDL_PollEvent(&event)) {
-        if (event.type == SDL_EVENT_QUIT) {
-            return false;
-        }
+    if (exit_frame_ != 0 && frame_count_ >= exit_frame_) {
+        return false;
     }
-    return true;
+    return !presenter_ || !presenter_->window_closed();
 }
 
-void VIRenderer::render_frame() {
-    // TODO: Implement x_scale/y_scale (2.10 fixed point) for proper framebuffer scaling
-    // TODO: Implement interlaced rendering (odd/even fields based on v_current bit 0)
-    // TODO: Implement VI filters (gamma, gamma_dither, divot, anti-aliasing, dedither)
-    
-    u32 origin = vi_->origin().origin;
-    u32 width = vi_->width().width;
-    u32 type = vi_->ctrl().type;
-
-    if (type == 0 || width == 0) {
-        // Blank screen
-        SDL_SetRenderDrawColor(renderer_, 0, 0, 0, 255);
-        SDL_RenderClear(renderer_);
-        SDL_RenderPresent(renderer_);
-        return;
-    }
+void VIRenderer::present() {
+    if (presenter_) presenter_->run();
+}
 
-    // Calculate height: use 3/4 of width for 4:3 aspect ratio
-    // TODO: Calculate from v_video register (v_end - v_start) / 2
-    u32 height = width * 3 / 4;
+void VIRenderer::stop_presenting() {
+    if (presenter_) presenter_->stop();
+}
 
-    // Recreate texture if dimensions changed
-    if (width != texture_width_ || height != texture_height_) {
-        if (texture_) SDL_DestroyTexture(texture_);
-        texture_ = SDL_CreateTexture(renderer_, SDL_PIXELFORMAT_RGBA8888, 
-                                      SDL_TEXTUREACCESS_STREAMING, width, height);
-        pixel_buffer_.resize(width * height, 0);
-        texture_width_ = width;
-        texture_height_ = height;
+void VIRenderer::keyboard_state(std::vector<u8>& keys) const {
+    if (presenter_) {
+        presenter_->keyboard_state(keys);
+    } else {
+        keys.clear();
     }
+}
 
-    // TODO: Add RDRAM bounds checking to prevent out-of-range reads
-    // Fill pixel buffer from RDRAM
-    for (u32 y = 0; y < height; y++) {
-        for (u32 x = 0; x < width; x++) {
-            u8 red = 0;
-            u8 green = 0;
-            u8 blue = 0;
-            u8 alpha = 255;
-
-            if (type == 3) {
-                // 32-bit RGBA 8888
-                u32 addr = origin + (y * width + x) * 4;
-                u32 pixel = rdram_.read_memory<u32>(addr);
-                red = (pixel >> 24) & 0xFF;
-                green = (pixel >> 16) & 0xFF;
-                blue = (pixel >> 8) & 0xFF;
-                alpha = pixel & 0xFF;
-            } else if (type == 2) {
-                // 16-bit RGBA 5551
-                u32 addr = origin + (y * width + x) * 2;
-                u16 pixel = rdram_.read_memory<u16>(addr);
-                red = ((pixel >> 11) & 0x1F) << 3;
-                green = ((pixel >> 6) & 0x1F) << 3;
-                blue = ((pixel >> 1) & 0x1F) << 3;
-                // Bit 0 is coverage, not display alpha - always show pixel
-                alpha = 255;
-            }
-            // NOTE: type=1 is reserved/undefined on real hardware
+void VIRenderer::render_frame() {
+    bool visible = output_.render(*vi_, rdram_);
+    u64 number = frame_count_++;
 
-            // Pack as RGBA8888 for SDL
-            pixel_buffer_[y * width + x] = (static_cast<u32>(red) << 24) |
-                                            (static_cast<u32>(green) << 16) |
-                                            (static_cast<u32>(blue) << 8) |
-                                            static_cast<u32>(alpha);
-        }
+    if (visible && dumper_.active()) {
+        dumper_.submit(number, output_.frame().data(), output_.width(), output_.height());
     }
+    if (!presenter_) return;
 
-    // Update texture with pixel buffer (stride = width * 4 bytes per pixel)
-    SDL_UpdateTexture(texture_, nullptr, pixel_buffer_.data(), width * sizeof(u32));
-    
-    // Render - SDL stretches texture to fill the window
-    SDL_RenderClear(renderer_);
-    SDL_RenderTexture(renderer_, texture_, nullptr, nullptr);
-    SDL_RenderPresent(renderer_);
+    if (!visible) {
+        presenter_->submit(nullptr, 0, 0);
+        return;
+    }
+    presenter_->submit(output_.frame().data(), output_.width(), output_.height());
 }
 
 } // namespace n64::interfaces
@@ -1,8 +1,11 @@
 #pragma once
 
 #include "../../utils/types.hpp"
+#include "vi_output.hpp"
+#include "vi_presenter.hpp"
+#include "frame_sink.hpp"
 #include <SDL3/SDL.h>
-#include <vector>
+#include <memory>
 
 namespace n64::memory {
 class RDRAM;  // Forward declaration
@@ -20,15 +23,26 @@ public:
     void render_frame();
     bool handle_events();  // Returns false if window closed
 
+    // Main thread: shows frames until the window closes or
+    // stop_presenting() is called. Returns at once when headless.
+    void present();
+    void stop_presenting();
+    // Host keyboard indexed by SDL scancode; empty when headless
+    void keyboard_state(std::vector<u8>& keys) const;
+    void set_profiler(memory::AccessProfiler* profiler) { output_.set_profiler(profiler); }
+
 private:
+    void setup_frame_dump();
+
     VI* vi_;
     memory::RDRAM& rdram_;
     SDL_Window* window_;
-    SDL_Renderer* renderer_;
-    SDL_Texture* texture_;
-    std::vector<u32> pixel_buffer_;  // RGBA pixel buffer
-    u32 texture_width_;
-    u32 texture_height_;
+    VIOutput output_;
+    std::unique_ptr<VIPresenter> presenter_;
+
+    FrameDumper dumper_;
+    u64 frame_count_ = 0;
+    u64 exit_frame_ = 0;  // 0 = run until the window is closed
 };
 
 } // namespace n64::interfaces
@@ -0,0 +1,116 @@
+#include "vi_scanout.hpp"
+#include "../../memory/rdram.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace n64::interfaces {
+
+namespace {
+
+void convert_rgba5551_scalar(const u8* src, u32* dst, u32 count) {
+    u8* out = reinterpret_cast<u8*>(dst);
+    for (u32 i = 0; i < count; i++) {
+        u16 pixel = (src[i * 2] << 8) | src[i * 2 + 1];
+        out[i * 4 + 0] = ((pixel >> 11) & 0x1F) << 3;
+        out[i * 4 + 1] = ((pixel >> 6) & 0x1F) << 3;
+        out[i * 4 + 2] = ((pixel >> 1) & 0x1F) << 3;
+        out[i * 4 + 3] = (pixel & 1) ? 0xFF : 0x7F;
+    }
+}
+
+#if defined(__SSE2__)
+// 8 pixels: swap to host order, then R = p >> 8, G = p >> 3, B = p << 2 with
+// the low three bits cleared, and A = 0x7F | bit 0 << 7. Interleaving
+// (R | G << 8) and (B | A << 8) as 16-bit lanes gives the R, G, B, A byte order.
+inline void convert_rgba5551_x8(const u8* src, u32* dst) {
+    const __m128i mask = _mm_set1_epi16(0x00F8);
+    const __m128i alpha = _mm_set1_epi16(0x7F00);
+    const __m128i one = _mm_set1_epi16(1);
+
+    __m128i p = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+    p = _mm_or_si128(_mm_srli_epi16(p, 8), _mm_slli_epi16(p, 8));
+
+    __m128i r = _mm_and_si128(_mm_srli_epi16(p, 8), mask);
+    __m128i g = _mm_and_si128(_mm_srli_epi16(p, 3), mask);
+    __m128i b = _mm_and_si128(_mm_slli_epi16(p, 2), mask);
+    __m128i rg = _mm_or_si128(r, _mm_slli_epi16(g, 8));
+    __m128i cvg = _mm_slli_epi16(_mm_and_si128(p, one), 15);
+    __m128i ba = _mm_or_si128(_mm_or_si128(b, alpha), cvg);
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_unpacklo_epi16(rg, ba));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 4), _mm_unpackhi_epi16(rg, ba));
+}
+#endif
+
+#if defined(__AVX2__)
+// Same as the SSE2 version on 16 pixels. The unpacks work per 128-bit lane,
+// so the halves are put back in order before storing.
+inline void convert_rgba5551_x16(const u8* src, u32* dst) {
+    const __m256i mask = _mm256_set1_epi16(0x00F8);
+    const __m256i alpha = _mm256_set1_epi16(0x7F00);
+    const __m256i one = _mm256_set1_epi16(1);
+
+    __m256i p = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+    p = _mm256_or_si256(_mm256_srli_epi16(p, 8), _mm256_slli_epi16(p, 8));
+
+    __m256i r = _mm256_and_si256(_mm256_srli_epi16(p, 8), mask);
+    __m256i g = _mm256_and_si256(_mm256_srli_epi16(p, 3), mask);
+    __m256i b = _mm256_and_si256(_mm256_slli_epi16(p, 2), mask);
+    __m256i rg = _mm256_or_si256(r, _mm256_slli_epi16(g, 8));
+    __m256i cvg = _mm256_slli_epi16(_mm256_and_si256(p, one), 15);
+    __m256i ba = _mm256_or_si256(_mm256_or_si256(b, alpha), cvg);
+
+    __m256i lo = _mm256_unpacklo_epi16(rg, ba);  // pixels 0-3, 8-11
+    __m256i hi = _mm256_unpackhi_epi16(rg, ba);  // pixels 4-7, 12-15
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), _mm256_permute2x128_si256(lo, hi, 0x20));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + 8), _mm256_permute2x128_si256(lo, hi, 0x31));
+}
+#endif
+
+} // namespace
+
+void convert_rgba5551(const u8* src, u32* dst, u32 count) {
+    u32 i = 0;
+#if defined(__AVX2__)
+    for (; i + 16 <= count; i += 16) {
+        convert_rgba5551_x16(src + i * 2, dst + i);
+    }
+#endif
+#if defined(__SSE2__)
+    for (; i + 8 <= count; i += 8) {
+        convert_rgba5551_x8(src + i * 2, dst + i);
+    }
+#endif
+    convert_rgba5551_scalar(src + i * 2, dst + i, count - i);
+}
+
+void convert_rgba8888(const u8* src, u32* dst, u32 count) {
+    std::memcpy(dst, src, static_cast<size_t>(count) * 4);
+}
+
+void scan_out_row(const memory::RDRAM& rdram, u32 addr, u32 type, u32* dst, u32 count) {
+    u32 bpp = (type == 3) ? 4 : 2;
+    u32 valid = 0;
+    if (addr < memory::RDRAM_MEMORY_SIZE) {
+        valid = std::min(count, (memory::RDRAM_MEMORY_SIZE - addr) / bpp);
+    }
+
+    if (valid > 0) {
+        const u8* src = rdram.view(addr, valid * bpp);
+        if (type == 3) {
+            convert_rgba8888(src, dst, valid);
+        } else {
+            convert_rgba5551(src, dst, valid);
+        }
+    }
+
+    // Past the end of RDRAM pixels read as zero
+    std::fill(dst + valid, dst + count, (type == 3) ? 0u : 0x7F000000u);
+}
+
+} // namespace n64::interfaces
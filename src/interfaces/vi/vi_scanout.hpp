@@ -0,0 +1,26 @@
+#pragma once
+
+#include "../../utils/types.hpp"
+
+namespace n64::memory {
+class RDRAM;
+}
+
+namespace n64::interfaces {
+
+// Framebuffer scan-out. Output pixels are RGBA8888 stored as bytes R, G, B, A
+// (SDL_PIXELFORMAT_RGBA32), which is also the byte order of a 32-bit RDRAM
+// framebuffer, so 32-bit rows are plain copies. The alpha byte is the pixel's
+// coverage, not display alpha: coverage (0-7) sits in its top three bits.
+
+// Converts count big-endian RGBA5551 pixels. Bit 0 is the top coverage bit;
+// the low two live in RDRAM's hidden bits, which are not emulated and read
+// as set, so alpha is 0xFF (coverage 7) or 0x7F (coverage 3).
+void convert_rgba5551(const u8* src, u32* dst, u32 count);
+void convert_rgba8888(const u8* src, u32* dst, u32 count);
+
+// Converts one row of count pixels starting at addr for a VI_CTRL type of
+// 2 (16-bit) or 3 (32-bit). The part of the row outside RDRAM reads as zero.
+void scan_out_row(const memory::RDRAM& rdram, u32 addr, u32 type, u32* dst, u32 count);
+
+} // namespace n64::interfaces
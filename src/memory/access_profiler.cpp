@@ -0,0 +1,148 @@
+#include "access_profiler.hpp"
+#include <algorithm>
+#include <cstdio>
+
+namespace n64::memory {
+
+namespace {
+
+constexpr const char* REGION_NAMES[] = {
+    "RDRAM", "RDRAM regs", "RSP mem", "RSP regs", "RDP", "MI", "VI", "AI", "PI", "RI", "SI",
+    "ROM", "PIF", "Cart save", "Unmapped",
+};
+constexpr const char* DMA_NAMES[] = {"PI", "SI", "SP", "AI", "DP cmd", "DP tex", "DP color", "DP Z", "VI"};
+constexpr u32 ACCESS_SIZES[] = {1, 2, 4, 8};
+constexpr size_t TOP_PCS = 64;
+
+}
+
+AccessProfiler::AccessProfiler(u32 sample_interval)
+    : sample_interval_(std::max(sample_interval, 1u))
+    , sample_countdown_(sample_interval_)
+    , pages_(PAGE_COUNT)
+    , dma_page_bytes_(PAGE_COUNT, 0)
+{
+}
+
+AccessProfiler::Region AccessProfiler::classify(u32 address)
+{
+    if (address <= RDRAM_MEMORY_END_ADDRESS) return Region::RDRAM;
+    if (address <= RDRAM_END_ADDRESS) return Region::RDRAMRegs;
+    if (address >= RSP_START_ADDRESS && address <= RSP_END_ADDRESS) {
+        return address < RSP_REGISTER_START_ADDRESS ? Region::RSPMemory : Region::RSPRegs;
+    }
+    if (address >= RDP_START_ADDRESS && address <= RDP_END_ADDRESS) return Region::RDP;
+    if (address >= MI_START_ADDRESS && address <= MI_END_ADDRESS) return Region::MI;
+    if (address >= VI_START_ADDRESS && address <= VI_END_ADDRESS) return Region::VI;
+    if (address >= AI_START_ADDRESS && address <= AI_END_ADDRESS) return Region::AI;
+    if (address >= RI_START_ADDRESS && address <= RI_END_ADDRESS) return Region::RI;
+    if (address >= PI_START_ADDRESS && address <= PI_END_ADDRESS) return Region::PI;
+    if (address >= SI_START_ADDRESS && address <= SI_END_ADDRESS) return Region::SI;
+    if (address >= ROM_START_ADDRESS && address <= ROM_END_ADDRESS) return Region::ROM;
+    if (address >= PIF_START_ADDRESS && address <= PIF_END_ADDRESS) return Region::PIF;
+    if (address >= PI_DOM2_ADDR2_START && address <= PI_DOM2_ADDR2_END) return Region::CartSave;
+    return Region::Unmapped;
+}
+
+void AccessProfiler::record_dma(Dma engine, u32 dram_address, u32 length, bool to_rdram,
+                                u32 rows, u32 skip)
+{
+    DmaCounter& dma = dma_[static_cast<size_t>(engine)];
+    dma.transfers++;
+    (to_rdram ? dma.bytes_to_rdram : dma.bytes_from_rdram) += static_cast<u64>(length) * rows;
+
+    // Not sampled: walking the pages is cheap next to the transfer or pixel
+    // work being reported
+    for (u32 row = 0; row < rows; row++) {
+        u32 address = (dram_address + row * (length + skip)) & 0x00FFFFFF;
+        u32 end = std::min(address + length, RDRAM_MEMORY_SIZE);
+        while (address < end) {
+            u32 page_end = std::min((address / PAGE_SIZE + 1) * PAGE_SIZE, end);
+            dma_page_bytes_[address / PAGE_SIZE] += page_end - address;
+            address = page_end;
+        }
+    }
+}
+
+bool AccessProfiler::dump(const std::string& path) const
+{
+    std::FILE* file = std::fopen(path.c_str(), "w");
+    if (!file) {
+        fprintf(stderr, "[PROFILE] Failed to open %s\n", path.c_str());
+        return false;
+    }
+
+    fprintf(file, "# CPU accesses by region (reads/writes per access size)\n");
+    fprintf(file, "%-10s %12s %12s %14s %21s %21s %21s %21s\n",
+            "region", "reads", "writes", "bytes", "u8", "u16", "u32", "u64");
+    for (size_t r = 0; r < regions_.size(); r++) {
+        u64 reads = 0, writes = 0, bytes = 0;
+        for (size_t s = 0; s < 4; s++) {
+            reads += regions_[r][s].reads;
+            writes += regions_[r][s].writes;
+            bytes += (regions_[r][s].reads + regions_[r][s].writes) * ACCESS_SIZES[s];
+        }
+        if (reads + writes == 0) continue;
+        fprintf(file, "%-10s %12llu %12llu %14llu", REGION_NAMES[r],
+                (unsigned long long)reads, (unsigned long long)writes, (unsigned long long)bytes);
+        for (size_t s = 0; s < 4; s++) {
+            fprintf(file, " %10llu/%-10llu", (unsigned long long)regions_[r][s].reads,
+                    (unsigned long long)regions_[r][s].writes);
+        }
+        fprintf(file, "\n");
+    }
+
+    fprintf(file, "\n# RDRAM traffic by engine (DMA, RDP command/texture/color/Z, VI scan-out)\n");
+    fprintf(file, "%-10s %12s %14s %14s\n", "engine", "transfers", "to RDRAM", "from RDRAM");
+    for (size_t e = 0; e < dma_.size(); e++) {
+        fprintf(file, "%-10s %12llu %14llu %14llu\n", DMA_NAMES[e],
+                (unsigned long long)dma_[e].transfers,
+                (unsigned long long)dma_[e].bytes_to_rdram,
+                (unsigned long long)dma_[e].bytes_from_rdram);
+    }
+
+    std::vector<std::pair<u32, Counter>> registers(registers_.begin(), registers_.end());
+    std::sort(registers.begin(), registers.end(), [](const auto& a, const auto& b) {
+        return a.second.reads + a.second.writes > b.second.reads + b.second.writes;
+    });
+    fprintf(file, "\n# Registers, busiest first\n");
+    fprintf(file, "%-10s %-10s %12s %12s\n", "address", "region", "reads", "writes");
+    for (const auto& [address, counter] : registers) {
+        fprintf(file, "0x%08X %-10s %12llu %12llu\n", address,
+                REGION_NAMES[static_cast<size_t>(classify(address))],
+                (unsigned long long)counter.reads, (unsigned long long)counter.writes);
+    }
+
+    // Top PCs by all accesses, then by register accesses, which is where
+    // polling loops show up
+    std::vector<std::pair<u32, PcCounter>> pcs(pcs_.begin(), pcs_.end());
+    for (bool mmio : {false, true}) {
+        auto key = [mmio](const PcCounter& c) { return mmio ? c.mmio : c.accesses; };
+        size_t count = std::min(pcs.size(), TOP_PCS);
+        std::partial_sort(pcs.begin(), pcs.begin() + count, pcs.end(), [&](const auto& a, const auto& b) {
+            return key(a.second) > key(b.second);
+        });
+        fprintf(file, "\n# Top PCs by %s\n", mmio ? "register accesses" : "accesses");
+        fprintf(file, "%-10s %12s %12s\n", "pc", "accesses", "registers");
+        for (size_t i = 0; i < count && key(pcs[i].second) > 0; i++) {
+            fprintf(file, "0x%08X %12llu %12llu\n", pcs[i].first,
+                    (unsigned long long)pcs[i].second.accesses, (unsigned long long)pcs[i].second.mmio);
+        }
+    }
+
+    fprintf(file, "\n# RDRAM pages (%u bytes): CPU accesses sampled 1 in %u, engine bytes exact\n",
+            PAGE_SIZE, sample_interval_);
+    fprintf(file, "%-10s %12s %12s %14s\n", "page", "reads", "writes", "engine bytes");
+    for (u32 page = 0; page < PAGE_COUNT; page++) {
+        if (pages_[page].reads + pages_[page].writes + dma_page_bytes_[page] == 0) continue;
+        fprintf(file, "0x%08X %12llu %12llu %14llu\n", page * PAGE_SIZE,
+                (unsigned long long)pages_[page].reads, (unsigned long long)pages_[page].writes,
+                (unsigned long long)dma_page_bytes_[page]);
+    }
+
+    std::fclose(file);
+    fprintf(stderr, "[PROFILE] Memory access profile written to %s\n", path.c_str());
+    return true;
+}
+
+} // namespace n64::memory
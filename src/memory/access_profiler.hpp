@@ -0,0 +1,107 @@
+#pragma once
+
+#include <array>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../utils/types.hpp"
+#include "memory_constants.hpp"
+
+namespace n64::memory {
+
+// Opt-in counters for memory traffic. MemoryMap reports every CPU access, and
+// the DMA engines, the RDP and VI scan-out report their RDRAM traffic; without
+// a profiler attached every path costs a null check. dump() writes a plain
+// text report.
+//
+// The RDP is split by kind: command list fetch, texture loads (TMEM and
+// TLUT), color image reads and writes, and depth image reads and writes. Its
+// per-pixel paths report one transfer per access, its span paths one per
+// span or rectangle.
+class AccessProfiler {
+public:
+    enum class Region : u8 {
+        RDRAM, RDRAMRegs, RSPMemory, RSPRegs, RDP, MI, VI, AI, PI, RI, SI,
+        ROM, PIF, CartSave, Unmapped, Count
+    };
+    enum class Dma : u8 { PI, SI, SP, AI, DPCommand, DPTexture, DPColor, DPDepth, VI, Count };
+
+    static constexpr u32 PAGE_SIZE = 4096;
+    static constexpr u32 PAGE_COUNT = RDRAM_MEMORY_SIZE / PAGE_SIZE;
+
+    // One in every sample_interval RDRAM accesses lands in the page heatmap
+    explicit AccessProfiler(u32 sample_interval = 16);
+
+    // PC of the instruction about to run; accesses are charged to it
+    void set_pc(u64 pc) { pc_ = static_cast<u32>(pc); }
+
+    template<typename T>
+    void record(u32 address, bool is_write) {
+        Region region = classify(address);
+        auto& sizes = regions_[static_cast<size_t>(region)];
+        Counter& by_size = sizes[size_index(sizeof(T))];
+        (is_write ? by_size.writes : by_size.reads)++;
+
+        PcCounter& pc = pcs_[pc_];
+        pc.accesses++;
+        if (is_register_region(region)) {
+            pc.mmio++;
+            Counter& reg = registers_[address & ~3u];
+            (is_write ? reg.writes : reg.reads)++;
+        }
+
+        if (region == Region::RDRAM && --sample_countdown_ == 0) {
+            sample_countdown_ = sample_interval_;
+            if (address < RDRAM_MEMORY_SIZE) {
+                Counter& page = pages_[address / PAGE_SIZE];
+                (is_write ? page.writes : page.reads)++;
+            }
+        }
+    }
+
+    // to_rdram: the engine wrote RDRAM; otherwise it read from it. Strided
+    // transfers pass their row count and the gap between rows.
+    void record_dma(Dma engine, u32 dram_address, u32 length, bool to_rdram,
+                    u32 rows = 1, u32 skip = 0);
+
+    bool dump(const std::string& path) const;
+
+private:
+    struct Counter {
+        u64 reads = 0;
+        u64 writes = 0;
+    };
+    struct PcCounter {
+        u64 accesses = 0;
+        u64 mmio = 0;
+    };
+    struct DmaCounter {
+        u64 transfers = 0;
+        u64 bytes_to_rdram = 0;
+        u64 bytes_from_rdram = 0;
+    };
+
+    // Same ranges, in the same order, as MemoryMap::read
+    static Region classify(u32 address);
+    static bool is_register_region(Region region) {
+        return region != Region::RDRAM && region != Region::RSPMemory && region != Region::ROM &&
+               region != Region::PIF && region != Region::CartSave && region != Region::Unmapped;
+    }
+    static constexpr size_t size_index(size_t bytes) {
+        return bytes == 1 ? 0 : bytes == 2 ? 1 : bytes == 4 ? 2 : 3;
+    }
+
+    u32 pc_ = 0;
+    u32 sample_interval_;
+    u32 sample_countdown_;
+
+    std::array<std::array<Counter, 4>, static_cast<size_t>(Region::Count)> regions_{};
+    std::unordered_map<u32, Counter> registers_;
+    std::unordered_map<u32, PcCounter> pcs_;
+    std::vector<Counter> pages_;          // sampled CPU accesses per RDRAM page
+    std::vector<u64> dma_page_bytes_;     // every DMA byte, per RDRAM page
+    std::array<DmaCounter, static_cast<size_t>(Dma::Count)> dma_{};
+};
+
+} // namespace n64::memory
@@ -0,0 +1,229 @@
+#include "cart_save.hpp"
+#include "memory_constants.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+namespace n64::memory {
+
+// FlashRAM status words reported for each mode (Macronix MX29L1100 IDs)
+constexpr u64 FLASH_STATUS_ERASE   = 0x1111800800C2001EULL;
+constexpr u64 FLASH_STATUS_WRITE   = 0x1111800400C2001EULL;
+constexpr u64 FLASH_STATUS_ID      = 0x1111800100C2001EULL;
+constexpr u64 FLASH_STATUS_READ    = 0x11118004F0000000ULL;
+
+void CartSave::set_save_path(const std::string& base_path, Type type) {
+    base_path_ = base_path;
+    if (type != Type::Unknown) {
+        select(type);
+    }
+}
+
+void CartSave::select(Type type) {
+    type_ = type;
+    if (base_path_.empty()) return;
+
+    try {
+        if (type == Type::Sram) {
+            file_ = std::make_unique<SaveFile>(base_path_ + ".sra", SRAM_SIZE, 0xFF);
+        } else {
+            file_ = std::make_unique<SaveFile>(base_path_ + ".fla", FLASHRAM_SIZE, 0xFF);
+        }
+    } catch (const std::exception& e) {
+        fprintf(stderr, "[SAVE] %s, saving disabled\n", e.what());
+    }
+}
+
+template<typename T>
+T CartSave::read(u32 address) {
+    if (type_ == Type::Unknown) select(Type::FlashRam);
+
+    u32 status = static_cast<u32>(flash_status_ >> 32);
+    T value = 0;
+    for (u32 i = 0; i < sizeof(T); i++) {
+        u32 byte_address = address + i;
+        u8 byte = 0;
+        if (type_ == Type::FlashRam) {
+            byte = static_cast<u8>(status >> ((3 - (byte_address & 3)) * 8));
+        } else if (file_) {
+            byte = file_->data()[(byte_address - PI_DOM2_ADDR2_START) & (SRAM_SIZE - 1)];
+        }
+        value = static_cast<T>((static_cast<u64>(value) << 8) | byte);
+    }
+    return value;
+}
+
+template<typename T>
+void CartSave::write(u32 address, T value) {
+    if (type_ == Type::Unknown) select(Type::FlashRam);
+
+    if (type_ == Type::FlashRam) {
+        if constexpr (sizeof(T) < 4) {
+            static u32 partial_write_count = 0;
+            if (partial_write_count++ < 20)
+                fprintf(stderr, "[SAVE] Ignoring %zu-byte FlashRAM write at 0x%08X\n", sizeof(T), address);
+        } else if (address == FLASHRAM_COMMAND_ADDRESS) {
+            flash_command(static_cast<u32>(static_cast<u64>(value) >> ((sizeof(T) - 4) * 8)));
+        }
+        return;
+    }
+    if (!file_) return;
+    for (u32 i = 0; i < sizeof(T); i++) {
+        u32 offset = (address + i - PI_DOM2_ADDR2_START) & (SRAM_SIZE - 1);
+        file_->data()[offset] = static_cast<u8>(static_cast<u64>(value) >> ((sizeof(T) - 1 - i) * 8));
+        file_->mark_dirty(offset, 1);
+    }
+}
+
+void CartSave::flash_command(u32 command) {
+    switch (command >> 24) {
+        case 0x4B:  // Select the sector holding the given page for erase
+            erase_offset_ = ((command & 0xFFFF) * FLASHRAM_PAGE_SIZE) & ~(FLASHRAM_SECTOR_SIZE - 1);
+            erase_length_ = FLASHRAM_SECTOR_SIZE;
+            flash_mode_ = FlashMode::Erase;
+            break;
+        case 0x3C:  // Select the whole chip for erase
+            erase_offset_ = 0;
+            erase_length_ = FLASHRAM_SIZE;
+            flash_mode_ = FlashMode::Erase;
+            break;
+        case 0x78:  // Erase mode
+            flash_mode_ = FlashMode::Erase;
+            flash_status_ = FLASH_STATUS_ERASE;
+            break;
+        case 0xA5:  // Select the page to program
+            write_offset_ = (command & 0xFFFF) * FLASHRAM_PAGE_SIZE;
+            flash_status_ = FLASH_STATUS_WRITE;
+            break;
+        case 0xB4:  // Page buffer load mode: the next DMA fills the buffer
+            flash_mode_ = FlashMode::Write;
+            break;
+        case 0xD2:  // Execute the pending erase or program
+            if (!file_) break;
+            if (flash_mode_ == FlashMode::Erase && erase_offset_ < FLASHRAM_SIZE) {
+                u32 length = std::min(erase_length_, FLASHRAM_SIZE - erase_offset_);
+                std::memset(file_->data() + erase_offset_, 0xFF, length);
+                file_->mark_dirty(erase_offset_, length);
+            } else if (flash_mode_ == FlashMode::Write && write_offset_ < FLASHRAM_SIZE) {
+                std::memcpy(file_->data() + write_offset_, page_buffer_, FLASHRAM_PAGE_SIZE);
+                file_->mark_dirty(write_offset_, FLASHRAM_PAGE_SIZE);
+            }
+            break;
+        case 0xE1:  // Status / silicon ID mode
+            flash_mode_ = FlashMode::Status;
+            flash_status_ = FLASH_STATUS_ID;
+            break;
+        case 0xF0:  // Array read mode
+            flash_mode_ = FlashMode::Read;
+            flash_status_ = FLASH_STATUS_READ;
+            break;
+        default:
+            fprintf(stderr, "[SAVE] Unknown FlashRAM command 0x%08X\n", command);
+            break;
+    }
+}
+
+void CartSave::dma_read(u32 cart_addr, u8* dst, u32 length) {
+    if (type_ == Type::Unknown) select(Type::Sram);
+    std::memset(dst, 0xFF, length);
+
+    if (type_ == Type::FlashRam) {
+        if (flash_mode_ == FlashMode::Status) {
+            for (u32 i = 0; i < std::min(length, 8u); i++) {
+                dst[i] = static_cast<u8>(flash_status_ >> (56 - i * 8));
+            }
+        } else if (flash_mode_ == FlashMode::Read && file_) {
+            // The array is addressed in 16-bit units on the cart bus
+            u32 offset = ((cart_addr - PI_DOM2_ADDR2_START) * 2) & (FLASHRAM_SIZE - 1);
+            std::memcpy(dst, file_->data() + offset, std::min(length, FLASHRAM_SIZE - offset));
+        }
+        return;
+    }
+
+    if (!file_) return;
+    u32 offset = (cart_addr - PI_DOM2_ADDR2_START) & (SRAM_SIZE - 1);
+    for (u32 done = 0; done < length; ) {
+        u32 chunk = std::min(length - done, SRAM_SIZE - offset);
+        std::memcpy(dst + done, file_->data() + offset, chunk);
+        done += chunk;
+        offset = 0;
+    }
+}
+
+void CartSave::dma_write(u32 cart_addr, const u8* src, u32 length) {
+    if (type_ == Type::Unknown) select(Type::Sram);
+
+    if (type_ == Type::FlashRam) {
+        if (flash_mode_ == FlashMode::Write) {
+            std::memcpy(page_buffer_, src, std::min(length, FLASHRAM_PAGE_SIZE));
+        }
+        return;
+    }
+
+    if (!file_) return;
+    u32 offset = (cart_addr - PI_DOM2_ADDR2_START) & (SRAM_SIZE - 1);
+    for (u32 done = 0; done < length; ) {
+        u32 chunk = std::min(length - done, SRAM_SIZE - offset);
+        std::memcpy(file_->data() + offset, src + done, chunk);
+        file_->mark_dirty(offset, chunk);
+        done += chunk;
+        offset = 0;
+    }
+}
+
+void CartSave::save_state(StateWriter& writer) const {
+    writer.begin_chunk("CART", 1);
+    writer.write(type_);
+    writer.write(flash_mode_);
+    writer.write(flash_status_);
+    writer.write(erase_offset_);
+    writer.write(erase_length_);
+    writer.write(write_offset_);
+    writer.write(page_buffer_);
+    u32 size = file_ ? file_->size() : 0;
+    writer.write(size);
+    if (size != 0) writer.write_rle(file_->data(), size);
+    writer.end_chunk();
+}
+
+bool CartSave::check_state(StateReader& reader) const {
+    if (!reader.open_chunk("CART", 1)) return false;
+    reader.skip_bytes(sizeof(type_) + sizeof(flash_mode_) + sizeof(flash_status_) + sizeof(erase_offset_)
+                      + sizeof(erase_length_) + sizeof(write_offset_) + sizeof(page_buffer_));
+    u32 size = reader.read<u32>();
+    if (size != 0 && size != SRAM_SIZE && size != FLASHRAM_SIZE) return false;
+    if (size != 0) reader.skip_rle(size);
+    return reader.ok();
+}
+
+void CartSave::load_state(StateReader& reader) {
+    if (!reader.open_chunk("CART", 1)) return;
+    Type type = reader.read<Type>();
+    if (type != Type::Unknown && type != type_) select(type);
+    reader.read(flash_mode_);
+    reader.read(flash_status_);
+    reader.read(erase_offset_);
+    reader.read(erase_length_);
+    reader.read(write_offset_);
+    reader.read(page_buffer_);
+    u32 size = reader.read<u32>();
+    if (size == 0) return;
+    if (file_ && file_->size() == size) {
+        reader.read_rle(file_->data(), size);
+        file_->mark_dirty(0, size);
+    }
+}
+
+// Explicit template instantiations
+template u8  CartSave::read<u8>(u32 address);
+template u16 CartSave::read<u16>(u32 address);
+template u32 CartSave::read<u32>(u32 address);
+template u64 CartSave::read<u64>(u32 address);
+
+template void CartSave::write<u8>(u32 address, u8 value);
+template void CartSave::write<u16>(u32 address, u16 value);
+template void CartSave::write<u32>(u32 address, u32 value);
+template void CartSave::write<u64>(u32 address, u64 value);
+
+} // namespace n64::memory
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "../utils/types.hpp"
+#include "../utils/save_state.hpp"
+#include "save_file.hpp"
+
+namespace n64::memory {
+
+constexpr u32 SRAM_SIZE = 0x8000;       // 256Kbit
+constexpr u32 FLASHRAM_SIZE = 0x20000;  // 1Mbit
+constexpr u32 FLASHRAM_PAGE_SIZE = 128;
+constexpr u32 FLASHRAM_SECTOR_SIZE = 0x4000;
+constexpr u32 FLASHRAM_COMMAND_ADDRESS = 0x08010000;
+
+// Cartridge backup memory on PI domain 2 (0x08000000): SRAM or FlashRAM.
+// The type is taken from CART_SAVE=sram|flashram when set. Otherwise it is
+// decided by the first access, since only FlashRAM is driven through CPU
+// reads and writes (status and command registers); SRAM is only ever DMAed.
+class CartSave {
+public:
+    enum class Type { Unknown, Sram, FlashRam };
+
+    CartSave() = default;
+
+    // Save files are <base>.sra / <base>.fla, opened when the type is known
+    void set_save_path(const std::string& base_path, Type type = Type::Unknown);
+
+    // CPU access, big-endian at any width. FlashRAM answers every word with
+    // the status register and takes commands from word writes to the command
+    // register (the high word of a doubleword write).
+    template<typename T>
+    [[nodiscard]] T read(u32 address);
+    template<typename T>
+    void write(u32 address, T value);
+
+    // PI DMA, cart -> RDRAM and RDRAM -> cart
+    void dma_read(u32 cart_addr, u8* dst, u32 length);
+    void dma_write(u32 cart_addr, const u8* src, u32 length);
+
+    [[nodiscard]] Type type() const { return type_; }
+
+    // Type, FlashRAM state and contents; loading writes the contents through
+    // to the save file
+    void save_state(StateWriter& writer) const;
+    void load_state(StateReader& reader);
+    [[nodiscard]] bool check_state(StateReader& reader) const;
+
+private:
+    enum class FlashMode { Idle, Read, Status, Erase, Write };
+
+    void select(Type type);
+    void flash_command(u32 command);
+
+    Type type_ = Type::Unknown;
+    std::string base_path_;
+    std::unique_ptr<SaveFile> file_;
+
+    // FlashRAM state machine
+    FlashMode flash_mode_ = FlashMode::Idle;
+    u64 flash_status_ = 0;
+    u32 erase_offset_ = 0;
+    u32 erase_length_ = 0;
+    u32 write_offset_ = 0;
+    u8 page_buffer_[FLASHRAM_PAGE_SIZE] = {};
+};
+
+} // namespace n64::memory
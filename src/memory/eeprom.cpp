@@ -0,0 +1,133 @@
+#include "eeprom.hpp"
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace n64::memory {
+
+Eeprom::Eeprom()
+    : data_(SIZE_16KBIT, 0xFF)
+{
+}
+
+Eeprom::~Eeprom() {
+    if (!thread_.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_one();
+    thread_.join();
+
+    // Whatever the flusher had not got to yet
+    if (dirty_) save(data_);
+    if (saves_ > 0) {
+        fprintf(stderr, "[EEPROM] %s: %llu saves\n", save_path_.c_str(), (unsigned long long)saves_);
+    }
+}
+
+void Eeprom::set_save_path(const std::string& path, u32 size) {
+    save_path_ = path;
+
+    std::ifstream file(save_path_, std::ios::binary | std::ios::ate);
+    if (size == 0) {
+        size = (file && file.tellg() == static_cast<std::streamoff>(SIZE_4KBIT)) ? SIZE_4KBIT : SIZE_16KBIT;
+    }
+    data_.assign(size, 0xFF);
+    if (file) {
+        file.seekg(0);
+        file.read(reinterpret_cast<char*>(data_.data()), size);
+    }
+    fprintf(stderr, "[EEPROM] %uKbit, %s\n", size * 8 / 1024, save_path_.c_str());
+
+    if (!thread_.joinable()) {
+        thread_ = std::thread(&Eeprom::run, this);
+    }
+}
+
+// Block numbers past the end wrap, as on the 4Kbit part
+void Eeprom::read_block(u8 block, u8* dst) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    u32 offset = (block * BLOCK_SIZE) & (size() - 1);
+    std::memcpy(dst, &data_[offset], BLOCK_SIZE);
+}
+
+void Eeprom::write_block(u8 block, const u8* src) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        u32 offset = (block * BLOCK_SIZE) & (size() - 1);
+        std::memcpy(&data_[offset], src, BLOCK_SIZE);
+        dirty_ = true;
+        write_count_++;
+    }
+    wake_.notify_one();
+}
+
+void Eeprom::save_state(StateWriter& writer) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    writer.write(size());
+    writer.write_bytes(data_.data(), data_.size());
+}
+
+bool Eeprom::check_state(StateReader& reader) const {
+    u32 size = reader.read<u32>();
+    if (size == SIZE_4KBIT || size == SIZE_16KBIT) reader.skip_bytes(size);
+    return reader.ok();
+}
+
+void Eeprom::load_state(StateReader& reader) {
+    u32 size = reader.read<u32>();
+    if (size != SIZE_4KBIT && size != SIZE_16KBIT) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        data_.resize(size);
+        reader.read_bytes(data_.data(), size);
+        dirty_ = true;
+        write_count_++;
+    }
+    wake_.notify_one();
+}
+
+void Eeprom::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopping_) {
+        wake_.wait(lock, [this] { return dirty_ || stopping_; });
+
+        // Coalesce: wait until a whole quiet period passes with no new writes
+        u64 seen;
+        do {
+            seen = write_count_;
+            wake_.wait_for(lock, QUIET_PERIOD, [this, seen] { return stopping_ || write_count_ != seen; });
+        } while (!stopping_ && write_count_ != seen);
+        if (stopping_) break;
+
+        std::vector<u8> snapshot = data_;
+        dirty_ = false;
+        lock.unlock();
+        save(snapshot);
+        lock.lock();
+    }
+}
+
+void Eeprom::save(const std::vector<u8>& snapshot) {
+    if (save_path_.empty()) return;
+
+    std::string temp_path = save_path_ + ".tmp";
+    {
+        std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+        if (!file.write(reinterpret_cast<const char*>(snapshot.data()), snapshot.size())) {
+            fprintf(stderr, "[EEPROM] Failed to write %s\n", temp_path.c_str());
+            return;
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(temp_path, save_path_, error);
+    if (error) {
+        fprintf(stderr, "[EEPROM] Failed to replace %s: %s\n", save_path_.c_str(), error.message().c_str());
+        return;
+    }
+    saves_++;
+}
+
+} // namespace n64::memory
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../utils/types.hpp"
+#include "../utils/save_state.hpp"
+
+namespace n64::memory {
+
+// Cartridge EEPROM on joybus channel 4, 4Kbit or 16Kbit, accessed in 8-byte
+// blocks. Writes only update memory and mark it dirty; a background thread
+// saves once writes have been quiet for QUIET_PERIOD (and again at shutdown),
+// writing a temporary file and renaming it over the save so a crash never
+// leaves a torn file.
+class Eeprom {
+public:
+    static constexpr u32 SIZE_4KBIT = 512;
+    static constexpr u32 SIZE_16KBIT = 2048;
+    static constexpr u32 BLOCK_SIZE = 8;
+    static constexpr auto QUIET_PERIOD = std::chrono::milliseconds(500);
+
+    Eeprom();
+    ~Eeprom();
+
+    Eeprom(const Eeprom&) = delete;
+    Eeprom& operator=(const Eeprom&) = delete;
+
+    // size 0 keeps the size of an existing save file, or 16Kbit without one
+    void set_save_path(const std::string& path, u32 size = 0);
+
+    [[nodiscard]] u32 size() const { return static_cast<u32>(data_.size()); }
+    // Type byte of the joybus status response
+    [[nodiscard]] u8 type_id() const { return size() == SIZE_4KBIT ? 0x80 : 0xC0; }
+
+    void read_block(u8 block, u8* dst) const;
+    void write_block(u8 block, const u8* src);
+
+    // Contents are written to the state; loading them also updates the save file
+    void save_state(StateWriter& writer) const;
+    void load_state(StateReader& reader);
+    [[nodiscard]] bool check_state(StateReader& reader) const;
+
+private:
+    void run();
+    void save(const std::vector<u8>& snapshot);
+
+    std::vector<u8> data_;
+    std::string save_path_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    bool dirty_ = false;
+    u64 write_count_ = 0;  // lets the flusher tell whether writes kept coming
+    bool stopping_ = false;
+    std::thread thread_;
+    u64 saves_ = 0;
+};
+
+} // namespace n64::memory
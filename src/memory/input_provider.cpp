@@ -0,0 +1,134 @@
+#include "input_provider.hpp"
+#include <cstring>
+#include <filesystem>
+
+namespace n64::memory {
+
+namespace {
+
+constexpr size_t HEADER_SIZE = sizeof(INPUT_LOG_MAGIC) + sizeof(INPUT_LOG_VERSION);
+constexpr size_t RECORD_SIZE = 12;
+
+} // namespace
+
+InputRecorder::InputRecorder(const std::string& path)
+    : path_(path)
+{
+    file_ = std::fopen(path.c_str(), "wb");
+    if (!file_) {
+        fprintf(stderr, "[INPUT] Failed to open %s, recording disabled\n", path.c_str());
+        return;
+    }
+    std::fwrite(INPUT_LOG_MAGIC, 1, sizeof(INPUT_LOG_MAGIC), file_);
+    std::fwrite(&INPUT_LOG_VERSION, sizeof(INPUT_LOG_VERSION), 1, file_);
+    fprintf(stderr, "[INPUT] Recording to %s\n", path.c_str());
+}
+
+InputRecorder::~InputRecorder()
+{
+    if (!file_) return;
+    std::fclose(file_);
+    fprintf(stderr, "[INPUT] Recorded %zu changes over %llu polls, %llu rewinds\n",
+            records_.size(), static_cast<unsigned long long>(polls_),
+            static_cast<unsigned long long>(rewinds_));
+}
+
+// Drops every change logged at or after poll_index, from memory and from the
+// file, and picks the state back up from the last change kept
+void InputRecorder::rewind(u64 poll_index)
+{
+    size_t kept = records_.size();
+    while (kept > 0 && records_[kept - 1].poll_index >= poll_index) kept--;
+    rewinds_++;
+    if (kept == records_.size()) return;
+
+    records_.resize(kept);
+    last_ = kept > 0 ? records_.back().state : ControllerState{};
+
+    std::fflush(file_);
+    std::error_code error;
+    std::filesystem::resize_file(path_, HEADER_SIZE + kept * RECORD_SIZE, error);
+    if (error) {
+        fprintf(stderr, "[INPUT] Failed to truncate %s: %s\n", path_.c_str(), error.message().c_str());
+    }
+    std::fseek(file_, static_cast<long>(HEADER_SIZE + kept * RECORD_SIZE), SEEK_SET);
+}
+
+ControllerState InputRecorder::poll(u64 poll_index)
+{
+    // Poll indices only grow, except after loading a save state or rewinding
+    if (file_ && polls_ > 0 && poll_index <= last_poll_) {
+        rewind(poll_index);
+    }
+    last_poll_ = poll_index;
+    polls_++;
+    // The log starts from the neutral state, so the first poll is only
+    // logged when something is held
+    if (file_ && host_ != last_) {
+        u8 record[RECORD_SIZE];
+        std::memcpy(record, &poll_index, 8);
+        std::memcpy(record + 8, &host_.buttons, 2);
+        record[10] = static_cast<u8>(host_.analog_x);
+        record[11] = static_cast<u8>(host_.analog_y);
+        std::fwrite(record, 1, RECORD_SIZE, file_);
+        records_.push_back({poll_index, host_});
+    }
+    last_ = host_;
+    return host_;
+}
+
+InputReplayer::InputReplayer(const std::string& path)
+{
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        fprintf(stderr, "[INPUT] Failed to open %s, replaying no input\n", path.c_str());
+        return;
+    }
+
+    char magic[sizeof(INPUT_LOG_MAGIC)];
+    u32 version = 0;
+    if (std::fread(magic, 1, sizeof(magic), file) != sizeof(magic)
+        || std::memcmp(magic, INPUT_LOG_MAGIC, sizeof(magic)) != 0
+        || std::fread(&version, sizeof(version), 1, file) != 1) {
+        fprintf(stderr, "[INPUT] %s is not an input log\n", path.c_str());
+        std::fclose(file);
+        return;
+    }
+    if (version != INPUT_LOG_VERSION) {
+        fprintf(stderr, "[INPUT] Unsupported input log version %u\n", version);
+        std::fclose(file);
+        return;
+    }
+
+    u8 record[RECORD_SIZE];
+    while (std::fread(record, 1, RECORD_SIZE, file) == RECORD_SIZE) {
+        InputRecord entry;
+        std::memcpy(&entry.poll_index, record, 8);
+        std::memcpy(&entry.state.buttons, record + 8, 2);
+        entry.state.analog_x = static_cast<s8>(record[10]);
+        entry.state.analog_y = static_cast<s8>(record[11]);
+        records_.push_back(entry);
+    }
+    std::fclose(file);
+    fprintf(stderr, "[INPUT] Replaying %zu changes from %s\n", records_.size(), path.c_str());
+}
+
+ControllerState InputReplayer::poll(u64 poll_index)
+{
+    // Poll indices only grow, except after loading a save state
+    if (next_ > 0 && records_[next_ - 1].poll_index > poll_index) {
+        next_ = 0;
+        current_ = {};
+    }
+    while (next_ < records_.size() && records_[next_].poll_index <= poll_index) {
+        current_ = records_[next_++].state;
+    }
+    if (next_ == records_.size() && !finished_ && !records_.empty()) {
+        finished_ = true;
+        fprintf(stderr, "[INPUT] Replay reached its last change at poll %llu\n",
+                static_cast<unsigned long long>(poll_index));
+    }
+    return current_;
+}
+
+} // namespace n64::memory
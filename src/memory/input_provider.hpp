@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "../utils/types.hpp"
+
+namespace n64::memory {
+
+struct ControllerState {
+    u16 buttons = 0;
+    s8 analog_x = 0;
+    s8 analog_y = 0;
+
+    bool operator==(const ControllerState&) const = default;
+};
+
+// Source of the controller state the PIF reports. The game sees input only
+// when it reads the controller over joybus, so the PIF asks the provider at
+// each of those reads, numbered from power-on; keying input to that index
+// rather than to host time makes a run reproducible.
+class InputProvider {
+public:
+    virtual ~InputProvider() = default;
+
+    // Latest host state (keyboard/pad), updated by the frontend
+    void set_host_state(const ControllerState& state) { host_ = state; }
+
+    [[nodiscard]] virtual ControllerState poll(u64 poll_index) = 0;
+
+protected:
+    ControllerState host_;
+};
+
+// Reports the host state as is
+class LiveInput : public InputProvider {
+public:
+    [[nodiscard]] ControllerState poll(u64) override { return host_; }
+};
+
+// Input log: "N64INPUT", u32 version, then one record per change of state
+// { u64 poll_index; u16 buttons; s8 analog_x; s8 analog_y; }
+constexpr char INPUT_LOG_MAGIC[8] = {'N', '6', '4', 'I', 'N', 'P', 'U', 'T'};
+constexpr u32 INPUT_LOG_VERSION = 1;
+
+struct InputRecord {
+    u64 poll_index;
+    ControllerState state;
+};
+
+// Reports the host state and logs every change with the poll it was seen at.
+// When the poll index goes backwards (a save state was loaded or the run was
+// rewound), the changes logged at or after the new index are dropped from the
+// log, so it always describes the timeline that was actually played.
+class InputRecorder : public InputProvider {
+public:
+    explicit InputRecorder(const std::string& path);
+    ~InputRecorder() override;
+
+    InputRecorder(const InputRecorder&) = delete;
+    InputRecorder& operator=(const InputRecorder&) = delete;
+
+    [[nodiscard]] ControllerState poll(u64 poll_index) override;
+
+private:
+    void rewind(u64 poll_index);
+
+    std::string path_;
+    std::FILE* file_ = nullptr;
+    ControllerState last_;
+    std::vector<InputRecord> records_;
+    u64 last_poll_ = 0;
+    u64 polls_ = 0;
+    u64 rewinds_ = 0;
+};
+
+// Plays a log back, ignoring the host. Past the end of the log the last
+// recorded state is held.
+class InputReplayer : public InputProvider {
+public:
+    explicit InputReplayer(const std::string& path);
+
+    [[nodiscard]] ControllerState poll(u64 poll_index) override;
+
+private:
+    std::vector<InputRecord> records_;
+    size_t next_ = 0;
+    ControllerState current_;
+    bool finished_ = false;
+};
+
+} // namespace n64::memory
@@ -0,0 +1,219 @@
+#include "joybus.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace n64::memory {
+
+u8 pak_data_crc(const u8* data) {
+    u8 crc = 0;
+    // 32 data bytes, then one zero byte to flush the register
+    for (u32 i = 0; i <= PAK_BLOCK_SIZE; i++) {
+        u8 byte = i < PAK_BLOCK_SIZE ? data[i] : 0;
+        for (int bit = 7; bit >= 0; bit--) {
+            u8 feedback = (crc & 0x80) ? 0x85 : 0x00;
+            crc = static_cast<u8>((crc << 1) | ((byte >> bit) & 1)) ^ feedback;
+        }
+    }
+    return crc;
+}
+
+u8 JoybusDevice::execute(const u8* tx, u8 tx_length, u8* rx, u8 rx_length) {
+    if (tx_length == 0) return 0;  // receive-only transfer, nothing is sent
+
+    auto command = std::find_if(commands_.begin(), commands_.end(),
+        [id = tx[0]](const Command& c) { return c.id == id; });
+    if (command == commands_.end() || tx_length < command->tx_length) {
+        return JOYBUS_NO_DEVICE;
+    }
+
+    // The device always sends its full response; the PIF keeps what fits
+    u8 response[PAK_BLOCK_SIZE + 1] = {};
+    (this->*command->handler)(tx, response);
+    std::memcpy(rx, response, std::min(rx_length, command->rx_length));
+    return rx_length < command->rx_length ? JOYBUS_OVERRUN : 0;
+}
+
+Mempak::Mempak(const std::string& path)
+    : file_(path, MEMPAK_SIZE, 0x00)
+{
+}
+
+void Mempak::read(u16 address, u8* data) {
+    if (address < MEMPAK_SIZE) {
+        std::memcpy(data, file_.data() + address, PAK_BLOCK_SIZE);
+    } else {
+        std::memset(data, 0, PAK_BLOCK_SIZE);
+    }
+}
+
+void Mempak::write(u16 address, const u8* data) {
+    if (address >= MEMPAK_SIZE) return;
+    std::memcpy(file_.data() + address, data, PAK_BLOCK_SIZE);
+    file_.mark_dirty(address, PAK_BLOCK_SIZE);
+}
+
+void Mempak::save_state(StateWriter& writer) const {
+    writer.write_rle(file_.data(), MEMPAK_SIZE);
+}
+
+void Mempak::load_state(StateReader& reader) {
+    reader.read_rle(file_.data(), MEMPAK_SIZE);
+    file_.mark_dirty(0, MEMPAK_SIZE);
+}
+
+bool Mempak::check_state(StateReader& reader) const {
+    reader.skip_rle(MEMPAK_SIZE);
+    return reader.ok();
+}
+
+void RumblePak::read(u16 address, u8* data) {
+    std::memset(data, (address >= 0x8000 && address < 0x9000) ? 0x80 : 0x00, PAK_BLOCK_SIZE);
+}
+
+void RumblePak::write(u16 address, const u8* data) {
+    if (address >= 0xC000) motor_on_ = data[0] & 1;
+}
+
+void RumblePak::save_state(StateWriter& writer) const {
+    writer.write(motor_on_);
+}
+
+void RumblePak::load_state(StateReader& reader) {
+    reader.read(motor_on_);
+}
+
+bool RumblePak::check_state(StateReader& reader) const {
+    reader.skip_bytes(sizeof(motor_on_));
+    return reader.ok();
+}
+
+void TransferPak::read(u16 address, u8* data) {
+    u8 value = 0x00;
+    if (address >= 0x8000 && address < 0x9000) {
+        value = powered_ ? 0x84 : 0x00;
+    } else if (address >= 0xB000 && address < 0xC000) {
+        value = powered_ ? 0xC0 : 0x00;  // powered, no cartridge
+    }
+    std::memset(data, value, PAK_BLOCK_SIZE);
+}
+
+void TransferPak::write(u16 address, const u8* data) {
+    if (address >= 0x8000 && address < 0x9000) powered_ = data[0] == 0x84;
+}
+
+void TransferPak::save_state(StateWriter& writer) const {
+    writer.write(powered_);
+}
+
+void TransferPak::load_state(StateReader& reader) {
+    reader.read(powered_);
+}
+
+bool TransferPak::check_state(StateReader& reader) const {
+    reader.skip_bytes(sizeof(powered_));
+    return reader.ok();
+}
+
+const JoybusDevice::Command Controller::COMMANDS[] = {
+    {0x00, 1, 3, static_cast<Handler>(&Controller::info)},
+    {0xFF, 1, 3, static_cast<Handler>(&Controller::info)},
+    {0x01, 1, 4, static_cast<Handler>(&Controller::read_buttons)},
+    {0x02, 3, PAK_BLOCK_SIZE + 1, static_cast<Handler>(&Controller::read_pak)},
+    {0x03, 3 + PAK_BLOCK_SIZE, 1, static_cast<Handler>(&Controller::write_pak)},
+};
+
+Controller::Controller()
+    : JoybusDevice(COMMANDS)
+    , input_(std::make_unique<LiveInput>())
+{
+}
+
+void Controller::info(const u8*, u8* rx) {
+    rx[0] = 0x05;
+    rx[1] = 0x00;
+    rx[2] = pak_ ? 0x01 : 0x02;
+}
+
+void Controller::read_buttons(const u8*, u8* rx) {
+    state_ = input_->poll(polls_++);
+    rx[0] = state_.buttons >> 8;
+    rx[1] = state_.buttons & 0xFF;
+    rx[2] = static_cast<u8>(state_.analog_x);
+    rx[3] = static_cast<u8>(state_.analog_y);
+}
+
+// Pak addresses carry a 5-bit CRC in their low bits, which is not checked.
+// Without a pak the data CRC comes back inverted, which is how games tell.
+void Controller::read_pak(const u8* tx, u8* rx) {
+    u16 address = ((tx[1] << 8) | tx[2]) & 0xFFE0;
+    if (pak_) {
+        pak_->read(address, rx);
+        rx[PAK_BLOCK_SIZE] = pak_data_crc(rx);
+    } else {
+        rx[PAK_BLOCK_SIZE] = pak_data_crc(rx) ^ 0xFF;
+    }
+}
+
+void Controller::write_pak(const u8* tx, u8* rx) {
+    u16 address = ((tx[1] << 8) | tx[2]) & 0xFFE0;
+    const u8* data = tx + 3;
+    if (pak_) pak_->write(address, data);
+    rx[0] = pak_ ? pak_data_crc(data) : pak_data_crc(data) ^ 0xFF;
+}
+
+void Controller::save_state(StateWriter& writer) const {
+    writer.write(state_);
+    writer.write(polls_);
+    writer.write(static_cast<bool>(pak_));
+    if (pak_) {
+        writer.write(pak_->kind());
+        pak_->save_state(writer);
+    }
+}
+
+void Controller::load_state(StateReader& reader) {
+    reader.read(state_);
+    reader.read(polls_);
+    // Pak state is applied only to the same kind of pak as was saved
+    if (!reader.read<bool>()) return;
+    auto kind = reader.read<ControllerPak::Kind>();
+    if (pak_ && pak_->kind() == kind) pak_->load_state(reader);
+}
+
+bool Controller::check_state(StateReader& reader) const {
+    reader.skip_bytes(sizeof(state_) + sizeof(polls_));
+    if (!reader.read<bool>()) return reader.ok();
+    auto kind = reader.read<ControllerPak::Kind>();
+    if (pak_ && pak_->kind() == kind && !pak_->check_state(reader)) return false;
+    return reader.ok();
+}
+
+const JoybusDevice::Command EepromDevice::COMMANDS[] = {
+    {0x00, 1, 3, static_cast<Handler>(&EepromDevice::info)},
+    {0xFF, 1, 3, static_cast<Handler>(&EepromDevice::info)},
+    {0x04, 2, Eeprom::BLOCK_SIZE, static_cast<Handler>(&EepromDevice::read_block)},
+    {0x05, 2 + Eeprom::BLOCK_SIZE, 1, static_cast<Handler>(&EepromDevice::write_block)},
+};
+
+EepromDevice::EepromDevice(Eeprom& eeprom)
+    : JoybusDevice(COMMANDS)
+    , eeprom_(eeprom)
+{
+}
+
+void EepromDevice::info(const u8*, u8* rx) {
+    rx[0] = 0x00;
+    rx[1] = eeprom_.type_id();
+    rx[2] = 0x00;
+}
+
+void EepromDevice::read_block(const u8* tx, u8* rx) {
+    eeprom_.read_block(tx[1], rx);
+}
+
+void EepromDevice::write_block(const u8* tx, u8* rx) {
+    eeprom_.write_block(tx[1], tx + 2);
+    rx[0] = 0x00;
+}
+
+} // namespace n64::memory
@@ -0,0 +1,170 @@
+#pragma once
+
+#include <memory>
+#include <span>
+#include <string>
+
+#include "../utils/types.hpp"
+#include "../utils/save_state.hpp"
+#include "eeprom.hpp"
+#include "input_provider.hpp"
+#include "save_file.hpp"
+
+namespace n64::memory {
+
+// Error bits the PIF sets in a transfer's rx length byte
+constexpr u8 JOYBUS_NO_DEVICE = 0x80;
+constexpr u8 JOYBUS_OVERRUN = 0x40;
+
+constexpr u32 MEMPAK_SIZE = 0x8000;
+constexpr u32 PAK_BLOCK_SIZE = 32;
+
+// CRC-8 (polynomial 0x85) the controller returns over a 32-byte pak block
+[[nodiscard]] u8 pak_data_crc(const u8* data);
+
+// A device on one joybus channel. Each device type lists the commands it
+// answers as {command byte, tx length, rx length, handler}; execute()
+// dispatches through that table, so unknown commands and short transfers are
+// handled in one place for every device.
+class JoybusDevice {
+public:
+    using Handler = void (JoybusDevice::*)(const u8* tx, u8* rx);
+    struct Command {
+        u8 id;
+        u8 tx_length;  // including the command byte
+        u8 rx_length;
+        Handler handler;
+    };
+
+    virtual ~JoybusDevice() = default;
+
+    // Runs the command in tx[0]; returns error bits for the rx length byte
+    u8 execute(const u8* tx, u8 tx_length, u8* rx, u8 rx_length);
+
+    virtual void save_state(StateWriter&) const {}
+    virtual void load_state(StateReader&) {}
+    // Walks the state load_state would apply, without applying it
+    [[nodiscard]] virtual bool check_state(StateReader&) const { return true; }
+
+protected:
+    explicit JoybusDevice(std::span<const Command> commands) : commands_(commands) {}
+
+private:
+    std::span<const Command> commands_;
+};
+
+// Accessory in a controller's pak slot, addressed in 32-byte blocks
+class ControllerPak {
+public:
+    enum class Kind : u8 { Mempak, Rumble, Transfer };
+
+    virtual ~ControllerPak() = default;
+
+    [[nodiscard]] virtual Kind kind() const = 0;
+    virtual void read(u16 address, u8* data) = 0;
+    virtual void write(u16 address, const u8* data) = 0;
+
+    virtual void save_state(StateWriter&) const {}
+    virtual void load_state(StateReader&) {}
+    [[nodiscard]] virtual bool check_state(StateReader&) const { return true; }
+};
+
+// 32KB controller pak on a mapped save file
+class Mempak : public ControllerPak {
+public:
+    explicit Mempak(const std::string& path);
+
+    [[nodiscard]] Kind kind() const override { return Kind::Mempak; }
+    void read(u16 address, u8* data) override;
+    void write(u16 address, const u8* data) override;
+
+    void save_state(StateWriter& writer) const override;
+    void load_state(StateReader& reader) override;
+    [[nodiscard]] bool check_state(StateReader& reader) const override;
+
+private:
+    SaveFile file_;
+};
+
+// Identifies itself at 0x8000; bit 0 written to 0xC000 drives the motor
+class RumblePak : public ControllerPak {
+public:
+    [[nodiscard]] Kind kind() const override { return Kind::Rumble; }
+    void read(u16 address, u8* data) override;
+    void write(u16 address, const u8* data) override;
+
+    [[nodiscard]] bool motor_on() const { return motor_on_; }
+
+    void save_state(StateWriter& writer) const override;
+    void load_state(StateReader& reader) override;
+    [[nodiscard]] bool check_state(StateReader& reader) const override;
+
+private:
+    bool motor_on_ = false;
+};
+
+// Powers up and identifies, but never reports a Game Boy cartridge
+class TransferPak : public ControllerPak {
+public:
+    [[nodiscard]] Kind kind() const override { return Kind::Transfer; }
+    void read(u16 address, u8* data) override;
+    void write(u16 address, const u8* data) override;
+
+    void save_state(StateWriter& writer) const override;
+    void load_state(StateReader& reader) override;
+    [[nodiscard]] bool check_state(StateReader& reader) const override;
+
+private:
+    bool powered_ = false;
+};
+
+// Standard controller: buttons come from an InputProvider at each read
+class Controller : public JoybusDevice {
+public:
+    Controller();
+
+    void set_input(std::unique_ptr<InputProvider> input) { input_ = std::move(input); }
+    [[nodiscard]] InputProvider& input() { return *input_; }
+    void set_pak(std::unique_ptr<ControllerPak> pak) { pak_ = std::move(pak); }
+
+    // State from a PIF chunk written before controllers had their own
+    void restore(const ControllerState& state, u64 polls) { state_ = state; polls_ = polls; }
+
+    void save_state(StateWriter& writer) const override;
+    void load_state(StateReader& reader) override;
+    [[nodiscard]] bool check_state(StateReader& reader) const override;
+
+private:
+    void info(const u8* tx, u8* rx);
+    void read_buttons(const u8* tx, u8* rx);
+    void read_pak(const u8* tx, u8* rx);
+    void write_pak(const u8* tx, u8* rx);
+
+    static const Command COMMANDS[];
+
+    std::unique_ptr<InputProvider> input_;
+    std::unique_ptr<ControllerPak> pak_;
+    ControllerState state_;  // as of the last read
+    u64 polls_ = 0;          // reads since power-on, the input provider's clock
+};
+
+// Cartridge EEPROM on channel 4
+class EepromDevice : public JoybusDevice {
+public:
+    explicit EepromDevice(Eeprom& eeprom);
+
+    void save_state(StateWriter& writer) const override { eeprom_.save_state(writer); }
+    void load_state(StateReader& reader) override { eeprom_.load_state(reader); }
+    [[nodiscard]] bool check_state(StateReader& reader) const override { return eeprom_.check_state(reader); }
+
+private:
+    void info(const u8* tx, u8* rx);
+    void read_block(const u8* tx, u8* rx);
+    void write_block(const u8* tx, u8* rx);
+
+    static const Command COMMANDS[];
+
+    Eeprom& eeprom_;
+};
+
+} // namespace n64::memory
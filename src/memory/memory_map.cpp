@@ -16,7 +16,8 @@ MemoryMap::MemoryMap(
     interfaces::SI& si,
     interfaces::RI& ri,
     interfaces::PI& pi,
-    PIF& pif
+    PIF& pif,
+    CartSave& cart_save
 )
     : rdram_(rdram)
     , rom_(rom)
@@ -29,12 +30,15 @@ MemoryMap::MemoryMap(
     , ri_(ri)
     , pi_(pi)
     , pif_(pif)
+    , cart_save_(cart_save)
 {
 }
 
 template<typename T>
 T MemoryMap::read(u32 address)
 {
+    if (profiler_) profiler_->record<T>(address, false);
+
     // RDRAM
     if (address >= RDRAM_START_ADDRESS && address <= RDRAM_END_ADDRESS) {
         return rdram_.read_memory<T>(address);
@@ -89,6 +93,11 @@ T MemoryMap::read(u32 address)
     if (address >= PIF_START_ADDRESS && address <= PIF_END_ADDRESS) {
         return pif_.read<T>(address);
     }
+
+    // SRAM / FlashRAM
+    if (address >= PI_DOM2_ADDR2_START && address <= PI_DOM2_ADDR2_END) {
+        return cart_save_.read<T>(address);
+    }
     
     static u32 unmapped_read_count = 0;
     if (unmapped_read_count++ < 20)
@@ -99,6 +108,8 @@ T MemoryMap::read(u32 address)
 template<typename T>
 void MemoryMap::write(u32 address, T value)
 {
+    if (profiler_) profiler_->record<T>(address, true);
+
     // RDRAM
     if (address >= RDRAM_START_ADDRESS && address <= RDRAM_END_ADDRESS) {
         rdram_.write_memory<T>(address, value);
@@ -158,6 +169,12 @@ void MemoryMap::write(u32 address, T value)
         pif_.write<T>(address, value);
         return;
     }
+
+    // SRAM / FlashRAM
+    if (address >= PI_DOM2_ADDR2_START && address <= PI_DOM2_ADDR2_END) {
+        cart_save_.write<T>(address, value);
+        return;
+    }
     
     static u32 unmapped_write_count = 0;
     if (unmapped_write_count++ < 20)
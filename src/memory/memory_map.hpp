@@ -14,6 +14,8 @@
 #include "../interfaces/ri.hpp"
 #include "../interfaces/pi/pi.hpp"
 #include "pif.hpp"
+#include "cart_save.hpp"
+#include "access_profiler.hpp"
 
 namespace n64::memory {
 
@@ -37,7 +39,8 @@ public:
         interfaces::SI& si,
         interfaces::RI& ri,
         interfaces::PI& pi,
-        PIF& pif
+        PIF& pif,
+        CartSave& cart_save
     );
     
     ~MemoryMap() = default;
@@ -48,6 +51,9 @@ public:
     template<typename T>
     void write(u32 address, T value);
 
+    // Every access is also reported to the profiler while one is attached
+    void set_profiler(AccessProfiler* profiler) { profiler_ = profiler; }
+
 private:
     // References to components (not owned)
     RDRAM& rdram_;
@@ -61,6 +67,9 @@ private:
     interfaces::RI& ri_;
     interfaces::PI& pi_;
     PIF& pif_;
+    CartSave& cart_save_;
+
+    AccessProfiler* profiler_ = nullptr;
 };
 
 }
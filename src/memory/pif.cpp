@@ -3,40 +3,109 @@
 #include "memory_constants.hpp"
 #include <stdexcept>
 #include <string>
-#include <fstream>
 
 namespace n64::memory {
 
 PIF::PIF()
 {
     memory_.fill(0);
-    eeprom_data_.fill(0xFF);
+    channels_[0] = std::make_unique<Controller>();
+    channels_[4] = std::make_unique<EepromDevice>(eeprom_);
 }
 
 PIF::~PIF()
 {
-    if (!save_path_.empty())
-        save_eeprom();
 }
 
-void PIF::set_save_path(const std::string& path)
+void PIF::set_save_path(const std::string& path, u32 eeprom_size)
 {
-    save_path_ = path;
-    load_eeprom();
+    eeprom_.set_save_path(path, eeprom_size);
 }
 
-void PIF::load_eeprom()
+Controller* PIF::controller(int port) const
 {
-    std::ifstream file(save_path_, std::ios::binary);
-    if (file)
-        file.read(reinterpret_cast<char*>(eeprom_data_.data()), eeprom_data_.size());
+    if (port < 0 || port >= CONTROLLER_PORTS) return nullptr;
+    return static_cast<Controller*>(channels_[port].get());
 }
 
-void PIF::save_eeprom()
+void PIF::connect_controller(int port)
 {
-    std::ofstream file(save_path_, std::ios::binary);
-    if (file)
-        file.write(reinterpret_cast<const char*>(eeprom_data_.data()), eeprom_data_.size());
+    if (port < 0 || port >= CONTROLLER_PORTS || channels_[port]) return;
+    channels_[port] = std::make_unique<Controller>();
+}
+
+void PIF::set_controller_pak(int port, std::unique_ptr<ControllerPak> pak)
+{
+    if (Controller* pad = controller(port)) pad->set_pak(std::move(pak));
+}
+
+void PIF::set_controller_state(const ControllerState& state, int port)
+{
+    if (Controller* pad = controller(port)) pad->input().set_host_state(state);
+}
+
+void PIF::set_input_provider(std::unique_ptr<InputProvider> input, int port)
+{
+    if (Controller* pad = controller(port)) pad->set_input(std::move(input));
+}
+
+// Chunk version 3 moved controller and EEPROM state into one chunk per
+// joybus channel ("JOY0".."JOY4")
+void PIF::save_state(StateWriter& writer) const
+{
+    writer.begin_chunk("PIF ", 3);
+    writer.write(memory_);
+    writer.end_chunk();
+
+    for (int channel = 0; channel < CHANNELS; channel++) {
+        if (!channels_[channel]) continue;
+        const char tag[5] = {'J', 'O', 'Y', static_cast<char>('0' + channel), '\0'};
+        writer.begin_chunk(tag, 1);
+        channels_[channel]->save_state(writer);
+        writer.end_chunk();
+    }
+}
+
+bool PIF::check_state(StateReader& reader) const
+{
+    if (!reader.open_chunk("PIF ", 3)) return false;
+    reader.skip_bytes(sizeof(memory_));
+
+    if (reader.chunk_version() < 3) {
+        reader.skip_bytes(sizeof(ControllerState));
+        if (reader.chunk_version() >= 2) reader.skip_bytes(sizeof(u64));
+        return eeprom_.check_state(reader);
+    }
+    if (!reader.ok()) return false;
+
+    for (int channel = 0; channel < CHANNELS; channel++) {
+        const char tag[5] = {'J', 'O', 'Y', static_cast<char>('0' + channel), '\0'};
+        if (!channels_[channel] || !reader.has_chunk(tag)) continue;
+        if (!reader.open_chunk(tag, 1) || !channels_[channel]->check_state(reader)) return false;
+    }
+    return true;
+}
+
+void PIF::load_state(StateReader& reader)
+{
+    if (!reader.open_chunk("PIF ", 3)) return;
+    reader.read(memory_);
+    layout_valid_ = false;
+
+    if (reader.chunk_version() < 3) {
+        auto state = reader.read<ControllerState>();
+        u64 polls = reader.chunk_version() >= 2 ? reader.read<u64>() : 0;
+        controller(0)->restore(state, polls);
+        eeprom_.load_state(reader);
+        return;
+    }
+
+    for (int channel = 0; channel < CHANNELS; channel++) {
+        const char tag[5] = {'J', 'O', 'Y', static_cast<char>('0' + channel), '\0'};
+        if (channels_[channel] && reader.has_chunk(tag) && reader.open_chunk(tag, 1)) {
+            channels_[channel]->load_state(reader);
+        }
+    }
 }
 
 template<typename T>
@@ -71,16 +140,13 @@ void PIF::dma_read_to_rdram(RDRAM& rdram, u32 dram_addr)
 {
     memory_[63] |= 0x01;
     process_commands();
-    for (int i = 0; i < 64; i++) {
-        rdram.write_memory<u8>(dram_addr + i, memory_[i]);
-    }
+    rdram.write_block(dram_addr, memory_.data(), static_cast<u32>(memory_.size()));
 }
 
 void PIF::dma_write_from_rdram(RDRAM& rdram, u32 dram_addr)
 {
-    for (int i = 0; i < 64; i++) {
-        memory_[i] = rdram.read_memory<u8>(dram_addr + i);
-    }
+    if (!rdram.contains(dram_addr, static_cast<u32>(memory_.size()))) return;
+    rdram.read_block(dram_addr, memory_.data(), static_cast<u32>(memory_.size()));
     process_commands();
 }
 
@@ -120,86 +186,70 @@ void PIF::process_commands()
 
     if ((cmd_byte & 0x01) == 0) return;
 
-    for (int channel = 0, pos = 0; channel < 5; channel++) {
-        if (!parse_channel(pos, channel)) break;
+    if (!layout_unchanged()) decode_commands();
+    for (u8 i = 0; i < transfer_count_; i++) {
+        const Transfer& t = transfers_[i];
+        const auto& device = channels_[t.channel];
+        u8 error = device
+            ? device->execute(&memory_[t.tx_pos], t.tx_length, &memory_[t.rx_pos], t.rx_length)
+            : JOYBUS_NO_DEVICE;
+        memory_[t.rx_length_pos] = (memory_[t.rx_length_pos] & 0x3F) | error;
     }
 
     memory_[63] &= ~0x01;
 }
 
-bool PIF::parse_channel(int& pos, int channel)
+bool PIF::layout_unchanged() const
 {
-    // Skip past any 0xFF nops
-    while (pos < 63 && memory_[pos] == 0xFF) pos++;
-    if (pos >= 63) return false;
-
-    u8 tx, rx;
-    u8 escape_code = memory_[pos++];
-
-    // Escape codes
-    switch (escape_code) {
-        case 0x00:
-            // Skip channel
-            return true;
-        case 0xFD:
-            // Reset channel
-            return true;
-        case 0xFE:
-            // End of frame
-            return false;
+    if (!layout_valid_) return false;
+    for (size_t i = 0; i < memory_.size(); i++) {
+        if ((memory_[i] & layout_mask_[i]) != layout_value_[i]) return false;
     }
+    return true;
+}
 
-    tx = escape_code & 0x3F;
-    rx = memory_[pos++] & 0x3F;
+// Walks the command block the way the PIF does: 0xFF is padding, 0x00 and
+// 0xFD skip a channel, 0xFE ends the block, anything else starts a transfer
+// of tx and rx lengths on the next channel. Transfers that would run past
+// the command byte end the block.
+void PIF::decode_commands()
+{
+    layout_mask_.fill(0);
+    transfer_count_ = 0;
 
-    if (channel > 0 && channel < 4) {
-        memory_[pos - 1] = rx | 0x80;
-        pos += tx + rx;
-        return true;
-    }
-
-    u8 response_pos = pos + tx;
-    u8 cmd_byte = memory_[pos++];
-
-    switch (cmd_byte) {
-        case 0x00: case 0xFF:
-            if (channel == 0) {
-                memory_[response_pos++] = 0x05;
-                memory_[response_pos++] = 0x00;
-                memory_[response_pos++] = 0x02;
-            } else {
-                memory_[response_pos++] = 0x00;
-                memory_[response_pos++] = 0xC0;
-                memory_[response_pos++] = 0x00;
-            }
-            break;
-        case 0x01:
-            memory_[response_pos++] = (controller_.buttons >> 8) & 0xFF;
-            memory_[response_pos++] = controller_.buttons & 0xFF;
-            memory_[response_pos++] = static_cast<u8>(controller_.analog_x);
-            memory_[response_pos++] = static_cast<u8>(controller_.analog_y);
-            break;
-        case 0x04: {
-            u8 block = memory_[pos];
-            for (int i = 0; i < 8; i++)
-                memory_[response_pos++] = eeprom_data_[(block << 3) + i];
-            break;
+    int pos = 0;
+    int channel = 0;
+    while (channel < CHANNELS && pos < 63) {
+        u8 escape_code = memory_[pos];
+        layout_mask_[pos] = 0xFF;
+        if (escape_code == 0xFF) {
+            pos++;
+            continue;
         }
-        case 0x05: {
-            u8 block = memory_[pos];
-            for (int i = 0; i < 8; i++)
-                eeprom_data_[(block << 3) + i] = memory_[pos + 1 + i];
-            memory_[response_pos++] = 0x00;
-            save_eeprom();
-            break;
+        if (escape_code == 0xFE) break;
+        pos++;
+        if (escape_code == 0x00 || escape_code == 0xFD) {
+            channel++;
+            continue;
         }
-        default:
-            pos += tx + rx;
-            return true;
+        if (pos >= 63) break;
+
+        u8 tx = escape_code & 0x3F;
+        u8 rx = memory_[pos] & 0x3F;
+        layout_mask_[pos] = 0x3F;
+        u8 rx_length_pos = static_cast<u8>(pos++);
+        if (pos + tx + rx > 63) break;
+
+        transfers_[transfer_count_++] = {static_cast<u8>(channel), static_cast<u8>(pos), tx,
+                                         static_cast<u8>(pos + tx), rx, rx_length_pos};
+        pos += tx + rx;
+        channel++;
     }
 
-    pos = response_pos;
-    return true;
+    for (size_t i = 0; i < memory_.size(); i++) {
+        layout_value_[i] = memory_[i] & layout_mask_[i];
+    }
+    layout_valid_ = true;
 }
 
 // Explicit template instantiations
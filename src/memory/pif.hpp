@@ -1,20 +1,19 @@
 #pragma once
 
 #include <array>
+#include <memory>
 #include <string>
 
 #include "../utils/types.hpp"
+#include "../utils/save_state.hpp"
+#include "eeprom.hpp"
+#include "input_provider.hpp"
+#include "joybus.hpp"
 
 namespace n64::memory {
 
 class RDRAM;
 
-struct ControllerState {
-    u16 buttons = 0;
-    s8 analog_x = 0;
-    s8 analog_y = 0;
-};
-
 class PIF {
 public:
     PIF();
@@ -29,18 +28,53 @@ public:
     void dma_write_from_rdram(RDRAM& rdram, u32 dram_addr);
 
     void process_commands();
-    void set_controller_state(const ControllerState& state) { controller_ = state; }
-    void set_save_path(const std::string& path);
+
+    // Controller ports 0-3; port 0 has a controller from power-on
+    static constexpr int CONTROLLER_PORTS = 4;
+    void connect_controller(int port);
+    void set_controller_pak(int port, std::unique_ptr<ControllerPak> pak);
+    // Host controller state, passed to the port's input provider
+    void set_controller_state(const ControllerState& state, int port = 0);
+    // Replaces the port's default live input (recording, replay)
+    void set_input_provider(std::unique_ptr<InputProvider> input, int port = 0);
+    // EEPROM save file; eeprom_size 0 keeps the size of an existing file
+    void set_save_path(const std::string& path, u32 eeprom_size = 0);
+
+    void save_state(StateWriter& writer) const;
+    void load_state(StateReader& reader);
+    // Checks the PIF chunk and the device chunks load_state would apply
+    [[nodiscard]] bool check_state(StateReader& reader) const;
 
 private:
-    bool parse_channel(int& pos, int channel);
-    void save_eeprom();
-    void load_eeprom();
+    // One joybus transfer in PIF RAM: tx bytes from the command byte on,
+    // then room for rx response bytes
+    struct Transfer {
+        u8 channel;
+        u8 tx_pos;
+        u8 tx_length;
+        u8 rx_pos;
+        u8 rx_length;
+        u8 rx_length_pos;  // the byte that receives the error bits
+    };
+
+    static constexpr int CHANNELS = 5;
+
+    void decode_commands();
+    [[nodiscard]] bool layout_unchanged() const;
+    [[nodiscard]] Controller* controller(int port) const;
 
     std::array<u8, 64> memory_;
-    std::array<u8, 2048> eeprom_data_;
-    std::string save_path_;
-    ControllerState controller_;
+    Eeprom eeprom_;
+    std::array<std::unique_ptr<JoybusDevice>, CHANNELS> channels_;
+
+    // PIF RAM is decoded into transfers once and the result is reused while
+    // the bytes the decode looked at (under these masks) stay the same,
+    // which they do for the command block a game sends every frame
+    std::array<Transfer, CHANNELS> transfers_{};
+    u8 transfer_count_ = 0;
+    std::array<u8, 64> layout_mask_{};
+    std::array<u8, 64> layout_value_{};
+    bool layout_valid_ = false;
 };
 
-} // namespace n64::memory
\ No newline at end of file
+} // namespace n64::memory
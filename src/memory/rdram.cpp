@@ -2,6 +2,7 @@
 #include <stdexcept>
 #include <string>
 #include <cstdio>
+#include <cstring>
 
 namespace n64::memory {
 
@@ -64,10 +65,101 @@ void RDRAM::write_memory(u32 address, T value)
         for (size_t i = 0; i < sizeof(T); i++) {
             memory_[address + i] = static_cast<u8>(value >> ((sizeof(T) - 1 - i) * 8));
         }
+        mark_dirty(address, sizeof(T));
+        if (address < watch_end_ && address + sizeof(T) > watch_start_) {
+            watch_(address, sizeof(T));
+        }
         return;
     }
 }
 
+void RDRAM::read_block(u32 address, u8* dst, u32 length) const
+{
+    if (!contains(address, length)) return;
+    std::memcpy(dst, memory_.data() + address, length);
+}
+
+void RDRAM::write_block(u32 address, const u8* src, u32 length)
+{
+    if (!contains(address, length)) return;
+    std::memcpy(memory_.data() + address, src, length);
+    if (length != 0) mark_dirty(address, length);
+    if (address < watch_end_ && address + length > watch_start_) {
+        watch_(address, length);
+    }
+}
+
+void RDRAM::set_write_watch(u32 start, u32 length, WriteWatch callback)
+{
+    watch_start_ = start;
+    watch_end_ = callback ? start + length : 0;
+    watch_ = std::move(callback);
+}
+
+RDRAM::DirtyPages RDRAM::take_dirty_pages()
+{
+    DirtyPages pages = dirty_pages_;
+    dirty_pages_.fill(0);
+    return pages;
+}
+
+void RDRAM::save_state(StateWriter& writer, bool include_memory) const
+{
+    writer.begin_chunk("RDRM", 2);
+    writer.write(include_memory);
+    if (include_memory) writer.write_rle(memory_.data(), RDRAM_MEMORY_SIZE);
+    writer.write(device_type_);
+    writer.write(device_id_);
+    writer.write(delay_);
+    writer.write(mode_);
+    writer.write(ref_interval_);
+    writer.write(ref_row_);
+    writer.write(ras_interval_);
+    writer.write(min_interval_);
+    writer.write(address_select_);
+    writer.write(device_manufacturer_);
+    writer.write(row_);
+    writer.end_chunk();
+}
+
+bool RDRAM::check_state(StateReader& reader) const
+{
+    if (!reader.open_chunk("RDRM", 2)) return false;
+    bool has_memory = reader.chunk_version() < 2 || reader.read<bool>();
+    if (has_memory) reader.skip_rle(RDRAM_MEMORY_SIZE);
+    size_t registers = sizeof(device_type_) + sizeof(device_id_) + sizeof(delay_) + sizeof(mode_)
+                     + sizeof(ref_interval_) + sizeof(ref_row_) + sizeof(ras_interval_)
+                     + sizeof(min_interval_) + sizeof(address_select_)
+                     + sizeof(device_manufacturer_) + sizeof(row_);
+    return reader.ok() && reader.remaining() == registers;
+}
+
+void RDRAM::load_state(StateReader& reader)
+{
+    if (!reader.open_chunk("RDRM", 2)) return;
+    // Version 1 always carried memory
+    bool has_memory = reader.chunk_version() < 2 || reader.read<bool>();
+    if (has_memory) {
+        reader.read_rle(memory_.data(), RDRAM_MEMORY_SIZE);
+        dirty_pages_.fill(~0ULL);
+    }
+    reader.read(device_type_);
+    reader.read(device_id_);
+    reader.read(delay_);
+    reader.read(mode_);
+    reader.read(ref_interval_);
+    reader.read(ref_row_);
+    reader.read(ras_interval_);
+    reader.read(min_interval_);
+    reader.read(address_select_);
+    reader.read(device_manufacturer_);
+    reader.read(row_);
+
+    if (has_memory && watch_ && watch_end_ > watch_start_) {
+        watch_(watch_start_, watch_end_ - watch_start_);
+    }
+}
+
 u32 RDRAM::read_register(RDRAM_REGISTERS_ADDRESS address) const
 {
     switch (address) {
@@ -1,8 +1,11 @@
 #pragma once
 
+#include <array>
+#include <functional>
 #include <vector>
 #include "../utils/types.hpp"
 #include "memory_constants.hpp"
+#include "../utils/save_state.hpp"
 
 namespace n64::memory {
 
@@ -32,11 +35,51 @@ public:
     template <typename T>
     void write_memory(u32 address, T value);
 
+    // Bulk access to the backing store (big-endian byte order, same as read_memory).
+    // Ranges that are not fully inside RDRAM are ignored, matching write_memory.
+    [[nodiscard]] bool contains(u32 address, u32 length) const {
+        return address < RDRAM_MEMORY_SIZE && length <= RDRAM_MEMORY_SIZE - address;
+    }
+    void read_block(u32 address, u8* dst, u32 length) const;
+    // Read-only view of the backing store, or nullptr when the range is not fully inside RDRAM
+    [[nodiscard]] const u8* view(u32 address, u32 length) const {
+        return contains(address, length) ? memory_.data() + address : nullptr;
+    }
+    void write_block(u32 address, const u8* src, u32 length);
+
+    // Single observer for writes that land in [start, start + length), used by
+    // caches built from RDRAM contents. A zero length removes the watch.
+    using WriteWatch = std::function<void(u32 address, u32 length)>;
+    void set_write_watch(u32 start, u32 length, WriteWatch callback);
+
+    // Pages written since the last take_dirty_pages(), one bit per DIRTY_PAGE_SIZE
+    static constexpr u32 DIRTY_PAGE_SIZE = 4096;
+    static constexpr u32 DIRTY_PAGE_COUNT = RDRAM_MEMORY_SIZE / DIRTY_PAGE_SIZE;
+    using DirtyPages = std::array<u64, DIRTY_PAGE_COUNT / 64>;
+    [[nodiscard]] DirtyPages take_dirty_pages();
+
     [[nodiscard]] u32 read_register(RDRAM_REGISTERS_ADDRESS address) const;
     void write_register(RDRAM_REGISTERS_ADDRESS address, u32 value);
 
+    // Memory is run-length packed (or left out, for rewind snapshots that
+    // track it by page); loading notifies the write watch
+    void save_state(StateWriter& writer, bool include_memory = true) const;
+    void load_state(StateReader& reader);
+    // Walks the chunk as load_state would, without applying anything
+    [[nodiscard]] bool check_state(StateReader& reader) const;
+
 private:
     std::vector<u8> memory_;  // 8MB on heap, not stack!
+    u32 watch_start_ = 0;
+    u32 watch_end_ = 0;
+    WriteWatch watch_;
+    DirtyPages dirty_pages_{};
+
+    void mark_dirty(u32 address, u32 length) {
+        for (u32 page = address / DIRTY_PAGE_SIZE; page <= (address + length - 1) / DIRTY_PAGE_SIZE; page++) {
+            dirty_pages_[page / 64] |= 1ULL << (page % 64);
+        }
+    }
     u32 device_type_;
     u32 device_id_;
     u32 delay_;
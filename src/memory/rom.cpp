@@ -2,42 +2,107 @@
 #include <fstream>
 #include <stdexcept>
 #include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 namespace n64::memory {
 
 ROM::ROM(interfaces::PI& pi, const std::string& path) : path_(path), pi_(pi) {
+#if !defined(_WIN32)
+    int fd = open(path_.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to open ROM file: " + path_);
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < 4) {
+        close(fd);
+        throw std::runtime_error("Failed to read ROM file: " + path_);
+    }
+    size_ = static_cast<size_t>(info.st_size);
+
+    // Peek at the first bytes to pick the mapping: swapped dumps need
+    // writable (private, copy-on-write) pages for in-place conversion
+    u8 magic[2];
+    if (pread(fd, magic, sizeof(magic), 0) != sizeof(magic)) {
+        close(fd);
+        throw std::runtime_error("Failed to read ROM file: " + path_);
+    }
+    bool big_endian = magic[0] == 0x80 && magic[1] == 0x37;
+    int protection = big_endian ? PROT_READ : PROT_READ | PROT_WRITE;
+    void* mapping = mmap(nullptr, size_, protection, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        throw std::runtime_error("Failed to map ROM file: " + path_);
+    }
+    data_ = static_cast<u8*>(mapping);
+    mapped_ = true;
+#else
     std::ifstream file(path_, std::ios::binary | std::ios::ate);
     if (!file.is_open()) {
         throw std::runtime_error("Failed to open ROM file: " + path_);
     }
     auto size = file.tellg();
     file.seekg(0);
-    memory_.resize(size);
-    file.read(reinterpret_cast<char*>(memory_.data()), size);
-    convert_to_big_endian();
+    heap_copy_.resize(size);
+    file.read(reinterpret_cast<char*>(heap_copy_.data()), size);
+    data_ = heap_copy_.data();
+    size_ = heap_copy_.size();
+#endif
+
+    format_ = detect_format();
+    if (format_ != ROM_FORMAT::Z64) {
+        chunk_ready_.assign((size_ + CHUNK_SIZE - 1) / CHUNK_SIZE, false);
+        pending_chunks_ = chunk_ready_.size();
+        fprintf(stderr, "[ROM] %s dump, converting to big-endian on access\n",
+                format_ == ROM_FORMAT::N64 ? "Word-swapped" : "Byte-swapped");
+    }
+    // Header and boot code
+    prepare(0, std::min<size_t>(size_, 0x1000));
     detect_cic();
-
-    file.close();
 }
 
 ROM::~ROM() {
+#if !defined(_WIN32)
+    if (mapped_) {
+        munmap(data_, size_);
+    }
+#endif
 }
 
 template<typename T>
 T ROM::read(u32 address) const {
     u32 offset = address - ROM_START_ADDRESS;
-    if (offset + sizeof(T) > memory_.size()) {
+    if (offset + sizeof(T) > size_) {
         throw std::runtime_error("Invalid ROM address: " + std::to_string(address));
     }
+    prepare(offset, sizeof(T));
     
     // Big-endian read
     T value = 0;
     for (size_t i = 0; i < sizeof(T); ++i) {
-        value = (value << 8) | memory_[offset + i];
+        value = (value << 8) | data_[offset + i];
     }
     return value;
 }
 
+void ROM::read_block(u32 address, u8* dst, u32 length) const {
+    u64 offset = static_cast<u64>(address) - ROM_START_ADDRESS;
+    u32 available = 0;
+    if (address >= ROM_START_ADDRESS && offset < size_) {
+        available = static_cast<u32>(std::min<u64>(length, size_ - offset));
+        prepare(offset, available);
+        std::memcpy(dst, data_ + offset, available);
+    }
+    std::memset(dst + available, 0, length - available);
+}
+
 // Explicit template instantiations
 template u8  ROM::read<u8>(u32 address) const;
 template u16 ROM::read<u16>(u32 address) const;
@@ -45,59 +110,63 @@ template u32 ROM::read<u32>(u32 address) const;
 template u64 ROM::read<u64>(u32 address) const;
 
 ROM_FORMAT ROM::detect_format() const {
-    if (memory_[0] == 0x80 && memory_[1] == 0x37) {
+    if (data_[0] == 0x80 && data_[1] == 0x37) {
         return ROM_FORMAT::Z64;
-    } else if (memory_[0] == 0x40 && memory_[1] == 0x12) {
+    } else if (data_[0] == 0x40 && data_[1] == 0x12) {
         return ROM_FORMAT::N64;
-    } else if (memory_[0] == 0x37 && memory_[1] == 0x80) {
+    } else if (data_[0] == 0x37 && data_[1] == 0x80) {
         return ROM_FORMAT::V64;
     } else {
         throw std::runtime_error("Unsupported ROM format");
     }
 }
 
-void ROM::convert_to_big_endian() {
-    switch (detect_format()) {
+void ROM::convert_chunk(size_t chunk) const {
+    size_t start = chunk * CHUNK_SIZE;
+    size_t end = std::min(start + CHUNK_SIZE, size_);
+    switch (format_) {
         case ROM_FORMAT::Z64:
-            // Already big-endian, nothing to do
             break;
         case ROM_FORMAT::N64:
             // Word-swapped (little-endian) - swap each 4 bytes
-            for (size_t i = 0; i < memory_.size(); i += 4) {
-                auto* ptr = reinterpret_cast<u32*>(&memory_[i]);
-                *ptr = byte_swap(*ptr);
+            for (size_t i = start; i + 4 <= end; i += 4) {
+                u32 word;
+                std::memcpy(&word, &data_[i], 4);
+                word = byte_swap(word);
+                std::memcpy(&data_[i], &word, 4);
             }
             break;
         case ROM_FORMAT::V64:
             // Byte-swapped - swap each 2 bytes
-            for (size_t i = 0; i < memory_.size(); i += 2) {
-                auto* ptr = reinterpret_cast<u16*>(&memory_[i]);
-                *ptr = byte_swap(*ptr);
+            for (size_t i = start; i + 2 <= end; i += 2) {
+                std::swap(data_[i], data_[i + 1]);
             }
             break;
     }
+    chunk_ready_[chunk] = true;
+    pending_chunks_--;
 }
 
 u32 ROM::parse_header() {
     // BSD DOM1
-    pi_.write_register(interfaces::PI_REGISTERS_ADDRESS::PI_BSD_DOM1_RLS, memory_[0x00000001] >> 4);
-    pi_.write_register(interfaces::PI_REGISTERS_ADDRESS::PI_BSD_DOM1_PGS, memory_[0x00000001]);
-    pi_.write_register(interfaces::PI_REGISTERS_ADDRESS::PI_BSD_DOM1_PWD, memory_[0x00000002]);
-    pi_.write_register(interfaces::PI_REGISTERS_ADDRESS::PI_BSD_DOM1_LAT, memory_[0x00000003]);
+    pi_.write_register(interfaces::PI_REGISTERS_ADDRESS::PI_BSD_DOM1_RLS, data_[0x00000001] >> 4);
+    pi_.write_register(interfaces::PI_REGISTERS_ADDRESS::PI_BSD_DOM1_PGS, data_[0x00000001]);
+    pi_.write_register(interfaces::PI_REGISTERS_ADDRESS::PI_BSD_DOM1_PWD, data_[0x00000002]);
+    pi_.write_register(interfaces::PI_REGISTERS_ADDRESS::PI_BSD_DOM1_LAT, data_[0x00000003]);
 
     clock_rate_ = read<u32>(0x00000004 + ROM_START_ADDRESS);
     u32 pc_address = read<u32>(0x00000008 + ROM_START_ADDRESS);
     lib_ultra_version_ = read<u32>(0x0000000C + ROM_START_ADDRESS);
     check_code_ = read<u64>(0x00000010 + ROM_START_ADDRESS);
     for (size_t i = 0; i < 20; ++i) {
-        game_name_ += static_cast<char>(memory_[0x00000020 + i]);
+        game_name_ += static_cast<char>(data_[0x00000020 + i]);
     }
-    category_code_ = static_cast<char>(memory_[0x0000003B]);
+    category_code_ = static_cast<char>(data_[0x0000003B]);
     for (size_t i = 0; i < 2; ++i) {
-        unique_code_[i] = static_cast<char>(memory_[0x0000003C + i]);
+        unique_code_[i] = static_cast<char>(data_[0x0000003C + i]);
     }
-    destination_code_ = static_cast<char>(memory_[0x0000003E]);
-    rom_version_ = memory_[0x0000003F];
+    destination_code_ = static_cast<char>(data_[0x0000003E]);
+    rom_version_ = data_[0x0000003F];
 
     return pc_address;
 }
@@ -113,12 +182,12 @@ u32 ROM::crc32(const u8* data, size_t len) {
 }
 
 void ROM::detect_cic() {
-    if (memory_.size() < 0x1000) {
+    if (size_ < 0x1000) {
         cic_type_ = CIC_TYPE::CIC_UNKNOWN;
         return;
     }
 
-    u32 bootcode_crc = crc32(&memory_[0x40], 0x1000 - 0x40);
+    u32 bootcode_crc = crc32(&data_[0x40], 0x1000 - 0x40);
 
     switch (bootcode_crc) {
         case 0x6170A4A1: cic_type_ = CIC_TYPE::CIC_6101; break;
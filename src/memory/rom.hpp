@@ -24,28 +24,61 @@ enum class CIC_TYPE {
     CIC_UNKNOWN
 };
 
+// The image is memory-mapped rather than read in. A .z64 dump is used in
+// place, read-only, so instances running the same ROM share the page cache.
+// Byte- or word-swapped dumps are mapped copy-on-write and converted to big
+// endian one 64KB chunk at a time, the first time the chunk is accessed.
 class ROM {
 public:
+    static constexpr size_t CHUNK_SIZE = 0x10000;
+
     ROM(interfaces::PI& pi, const std::string& path);
     ~ROM();
 
+    ROM(const ROM&) = delete;
+    ROM& operator=(const ROM&) = delete;
+
     template<typename T>
     [[nodiscard]] T read(u32 address) const;
 
+    // Bulk cart-bus access for PI DMA. view() returns nullptr unless the range
+    // is fully inside the ROM; read_block() reads bytes past the end as 0.
+    [[nodiscard]] const u8* view(u32 address, u32 length) const {
+        u64 offset = static_cast<u64>(address) - ROM_START_ADDRESS;
+        if (address < ROM_START_ADDRESS || offset + length > size_) return nullptr;
+        prepare(offset, length);
+        return data_ + offset;
+    }
+    void read_block(u32 address, u8* dst, u32 length) const;
+
     u32 parse_header();
 
-    [[nodiscard]] size_t size() const { return memory_.size(); }
+    [[nodiscard]] size_t size() const { return size_; }
     [[nodiscard]] CIC_TYPE cic_type() const { return cic_type_; }
     [[nodiscard]] u8 cic_seed() const;
 
 private:
 
     [[nodiscard]] ROM_FORMAT detect_format() const;
-    void convert_to_big_endian();
+    // Converts any chunk of [offset, offset + length) not yet in big-endian order
+    void prepare(u64 offset, u64 length) const {
+        if (pending_chunks_ == 0) return;
+        for (u64 chunk = offset / CHUNK_SIZE; chunk <= (offset + length - 1) / CHUNK_SIZE; chunk++) {
+            if (!chunk_ready_[chunk]) convert_chunk(chunk);
+        }
+    }
+    void convert_chunk(size_t chunk) const;
     void detect_cic();
     [[nodiscard]] static u32 crc32(const u8* data, size_t len);
 
-    std::vector<u8> memory_;
+    u8* data_ = nullptr;
+    size_t size_ = 0;
+    bool mapped_ = false;
+    std::vector<u8> heap_copy_;  // backing store where mmap is unavailable
+    ROM_FORMAT format_ = ROM_FORMAT::Z64;
+    mutable std::vector<bool> chunk_ready_;
+    mutable size_t pending_chunks_ = 0;
+
     std::string path_;
     interfaces::PI& pi_;
     CIC_TYPE cic_type_ = CIC_TYPE::CIC_UNKNOWN;
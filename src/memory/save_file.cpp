@@ -0,0 +1,137 @@
+#include "save_file.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace n64::memory {
+
+SaveFile::SaveFile(const std::string& path, u32 size, u8 fill_byte)
+    : path_(path)
+    , size_(size)
+    , dirty_words_((size + PAGE_SIZE * 64 - 1) / (PAGE_SIZE * 64))
+{
+    dirty_ = std::make_unique<std::atomic<u64>[]>(dirty_words_);
+    for (u32 i = 0; i < dirty_words_; i++) {
+        dirty_[i].store(0, std::memory_order_relaxed);
+    }
+
+#if !defined(_WIN32)
+    int fd = open(path_.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to open save file: " + path_);
+    }
+    struct stat info;
+    fstat(fd, &info);
+    if (info.st_size < static_cast<off_t>(size_)) {
+        // Pad a new or short file with the erased-state byte
+        std::vector<u8> fill(size_ - info.st_size, fill_byte);
+        if (pwrite(fd, fill.data(), fill.size(), info.st_size) != static_cast<ssize_t>(fill.size())) {
+            close(fd);
+            throw std::runtime_error("Failed to extend save file: " + path_);
+        }
+    }
+    void* mapping = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        throw std::runtime_error("Failed to map save file: " + path_);
+    }
+    data_ = static_cast<u8*>(mapping);
+#else
+    heap_copy_.assign(size_, fill_byte);
+    std::ifstream file(path_, std::ios::binary);
+    if (file) {
+        file.read(reinterpret_cast<char*>(heap_copy_.data()), size_);
+    }
+    data_ = heap_copy_.data();
+#endif
+
+    fprintf(stderr, "[SAVE] %s (%u bytes)\n", path_.c_str(), size_);
+    thread_ = std::thread(&SaveFile::run, this);
+}
+
+SaveFile::~SaveFile() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_one();
+    thread_.join();
+    flush_dirty();
+
+#if !defined(_WIN32)
+    munmap(data_, size_);
+#endif
+    if (pages_flushed_ > 0) {
+        fprintf(stderr, "[SAVE] %s: %llu page writes\n", path_.c_str(), (unsigned long long)pages_flushed_);
+    }
+}
+
+void SaveFile::mark_dirty(u32 offset, u32 length) {
+    if (length == 0 || offset >= size_) return;
+    u32 first = offset / PAGE_SIZE;
+    u32 last = (std::min(offset + length, size_) - 1) / PAGE_SIZE;
+    for (u32 page = first; page <= last; page++) {
+        dirty_[page / 64].fetch_or(1ULL << (page % 64), std::memory_order_relaxed);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_ = true;
+    wake_.notify_one();
+}
+
+// Waits for writes, then for FLUSH_DELAY without new ones, so a burst of
+// page writes (a whole save slot) goes out as one flush
+void SaveFile::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopping_) {
+        wake_.wait(lock, [this] { return pending_ || stopping_; });
+        while (pending_ && !stopping_) {
+            pending_ = false;
+            wake_.wait_for(lock, FLUSH_DELAY, [this] { return pending_ || stopping_; });
+        }
+        if (stopping_) break;
+
+        lock.unlock();
+        flush_dirty();
+        lock.lock();
+    }
+}
+
+void SaveFile::flush_dirty() {
+#if !defined(_WIN32)
+    static const u32 host_page = static_cast<u32>(sysconf(_SC_PAGESIZE));
+    for (u32 word = 0; word < dirty_words_; word++) {
+        u64 bits = dirty_[word].exchange(0, std::memory_order_acq_rel);
+        while (bits) {
+            u32 page = word * 64 + __builtin_ctzll(bits);
+            bits &= bits - 1;
+            // msync wants the start aligned to the host page, which may be larger
+            u32 offset = page * PAGE_SIZE;
+            u32 aligned = offset & ~(host_page - 1);
+            msync(data_ + aligned, std::min(PAGE_SIZE, size_ - offset) + (offset - aligned), MS_SYNC);
+            pages_flushed_++;
+        }
+    }
+#else
+    bool dirty = false;
+    for (u32 word = 0; word < dirty_words_; word++) {
+        dirty |= dirty_[word].exchange(0, std::memory_order_acq_rel) != 0;
+    }
+    if (!dirty) return;
+    std::ofstream file(path_, std::ios::binary);
+    if (file) {
+        file.write(reinterpret_cast<const char*>(data_), size_);
+        pages_flushed_ += (size_ + PAGE_SIZE - 1) / PAGE_SIZE;
+    }
+#endif
+}
+
+} // namespace n64::memory
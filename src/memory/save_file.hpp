@@ -0,0 +1,60 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../utils/types.hpp"
+
+namespace n64::memory {
+
+// Fixed-size save file mapped into memory. The emulation thread writes
+// straight into data() and reports the range with mark_dirty(); a background
+// thread msyncs the dirty pages once writes have been quiet for FLUSH_DELAY,
+// so persisting a save never blocks emulation. Everything still dirty is
+// flushed on destruction.
+class SaveFile {
+public:
+    static constexpr u32 PAGE_SIZE = 4096;
+    static constexpr auto FLUSH_DELAY = std::chrono::milliseconds(500);
+
+    // Creates the file filled with fill_byte if it is missing or too short
+    SaveFile(const std::string& path, u32 size, u8 fill_byte);
+    ~SaveFile();
+
+    SaveFile(const SaveFile&) = delete;
+    SaveFile& operator=(const SaveFile&) = delete;
+
+    [[nodiscard]] u8* data() { return data_; }
+    [[nodiscard]] const u8* data() const { return data_; }
+    [[nodiscard]] u32 size() const { return size_; }
+    [[nodiscard]] const std::string& path() const { return path_; }
+
+    void mark_dirty(u32 offset, u32 length);
+
+private:
+    void run();
+    void flush_dirty();
+
+    std::string path_;
+    u32 size_;
+    u8* data_ = nullptr;
+    std::vector<u8> heap_copy_;  // backing store where mmap is unavailable
+
+    std::unique_ptr<std::atomic<u64>[]> dirty_;  // one bit per page
+    u32 dirty_words_;
+    u64 pages_flushed_ = 0;
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    bool pending_ = false;
+    bool stopping_ = false;
+    std::thread thread_;
+};
+
+} // namespace n64::memory
@@ -1,6 +1,11 @@
 #include "n64_system.hpp"
 #include <algorithm>
+#include <chrono>
 #include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <thread>
 #include <SDL3/SDL.h>
 
 namespace n64 {
@@ -11,22 +16,82 @@ N64System::N64System(const std::string& rom_path)
     , pi_(mi_)
     , ri_()
     , rom_(pi_, rom_path)
+    , cart_save_()
     , rdp_(rdram_, mi_)
     , rsp_(mi_, rdp_, rdram_)
     , ai_(mi_, rdram_)
     , vi_(mi_, rdram_)
     , pif_()
     , si_(mi_, rdram_, pif_)
-    , memory_map_(rdram_, rom_, mi_, rdp_, rsp_, ai_, vi_, si_, ri_, pi_, pif_)
+    , memory_map_(rdram_, rom_, mi_, rdp_, rsp_, ai_, vi_, si_, ri_, pi_, pif_, cart_save_)
     , cpu_(memory_map_)
 {
-    pi_.set_dma_targets(rom_, rdram_);
+    pi_.set_dma_targets(rom_, rdram_, cart_save_);
 
     std::string save_path = rom_path;
     auto dot = save_path.rfind('.');
     if (dot != std::string::npos)
         save_path = save_path.substr(0, dot);
-    pif_.set_save_path(save_path + ".eep");
+    // EEPROM_SIZE=4k|16k, otherwise taken from an existing save (16Kbit if none)
+    u32 eeprom_size = 0;
+    if (const char* env = std::getenv("EEPROM_SIZE")) {
+        if (std::strcmp(env, "4k") == 0) eeprom_size = memory::Eeprom::SIZE_4KBIT;
+        if (std::strcmp(env, "16k") == 0) eeprom_size = memory::Eeprom::SIZE_16KBIT;
+    }
+    pif_.set_save_path(save_path + ".eep", eeprom_size);
+
+    // CART_SAVE=sram|flashram overrides detection from the first access
+    memory::CartSave::Type save_type = memory::CartSave::Type::Unknown;
+    if (const char* env = std::getenv("CART_SAVE")) {
+        if (std::strcmp(env, "sram") == 0) save_type = memory::CartSave::Type::Sram;
+        if (std::strcmp(env, "flashram") == 0) save_type = memory::CartSave::Type::FlashRam;
+    }
+    cart_save_.set_save_path(save_path, save_type);
+    state_path_ = save_path + ".state";
+
+    // CONTROLLERS=1-4 ports connected (keyboard drives port 0);
+    // CONTROLLER_PAK=<pak>[,<pak>...] per port: mempak, rumble, transfer or none
+    if (const char* env = std::getenv("CONTROLLERS")) {
+        int count = std::clamp(std::atoi(env), 1, memory::PIF::CONTROLLER_PORTS);
+        for (int port = 1; port < count; port++) pif_.connect_controller(port);
+    }
+    if (const char* env = std::getenv("CONTROLLER_PAK")) {
+        std::string list = env;
+        size_t start = 0;
+        for (int port = 0; port < memory::PIF::CONTROLLER_PORTS && start <= list.size(); port++) {
+            size_t end = std::min(list.find(',', start), list.size());
+            std::string pak = list.substr(start, end - start);
+            start = end + 1;
+            try {
+                if (pak == "mempak") {
+                    std::string suffix = port == 0 ? "" : "." + std::to_string(port + 1);
+                    pif_.set_controller_pak(port, std::make_unique<memory::Mempak>(save_path + suffix + ".mpk"));
+                } else if (pak == "rumble") {
+                    pif_.set_controller_pak(port, std::make_unique<memory::RumblePak>());
+                } else if (pak == "transfer") {
+                    pif_.set_controller_pak(port, std::make_unique<memory::TransferPak>());
+                }
+            } catch (const std::exception& e) {
+                fprintf(stderr, "[PIF] %s, port %d has no pak\n", e.what(), port + 1);
+            }
+        }
+    }
+
+    // INPUT_RECORD=<file> logs controller input per joybus read,
+    // INPUT_REPLAY=<file> plays such a log back instead of the keyboard
+    const char* replay = std::getenv("INPUT_REPLAY");
+    if (replay && *replay) {
+        pif_.set_input_provider(std::make_unique<memory::InputReplayer>(replay));
+    } else if (const char* env = std::getenv("INPUT_RECORD")) {
+        pif_.set_input_provider(std::make_unique<memory::InputRecorder>(env));
+    }
+
+    if (const char* trace_path = std::getenv("RDP_TRACE")) {
+        rdp_.start_trace(trace_path);
+    }
+    if (const char* stats_path = std::getenv("RDP_STATS")) {
+        rdp_.start_stats_log(stats_path);
+    }
     
     fprintf(stderr, "[BOOT] ROM loaded: %zu bytes\n", rom_.size());
     fprintf(stderr, "[BOOT] CIC seed: 0x%02X\n", rom_.cic_seed());
@@ -74,6 +139,130 @@ N64System::N64System(const std::string& rom_path)
     ri_.write_register(0x04700010, 0x00063634); // RI_REFRESH
 
     fprintf(stderr, "[BOOT] Boot complete, starting execution\n");
+
+    // STATE_LOAD=<file> resumes from a state instead of the boot above,
+    // STATE_SAVE=<file> writes one when emulation stops
+    if (const char* env = std::getenv("STATE_LOAD")) {
+        load_state(env);
+    }
+    if (const char* env = std::getenv("STATE_SAVE")) {
+        exit_state_path_ = env;
+    }
+
+    if (const char* env = std::getenv("REWIND_MB")) {
+        size_t megabytes = std::strtoul(env, nullptr, 10);
+        if (megabytes > 0) {
+            rewind_ = std::make_unique<RewindBuffer>(rdram_, megabytes << 20);
+        }
+        if (const char* interval = std::getenv("REWIND_INTERVAL")) {
+            rewind_interval_ = std::max(1, std::atoi(interval));
+        }
+    }
+
+    // MEM_PROFILE=<file> counts CPU, DMA, RDP and VI memory traffic and writes the
+    // report there on exit; MEM_PROFILE_SAMPLE sets the RDRAM heatmap rate
+    if (const char* env = std::getenv("MEM_PROFILE")) {
+        profile_path_ = env;
+        u32 sample = 16;
+        if (const char* rate = std::getenv("MEM_PROFILE_SAMPLE")) {
+            sample = static_cast<u32>(std::max(1, std::atoi(rate)));
+        }
+        profiler_ = std::make_unique<memory::AccessProfiler>(sample);
+        memory_map_.set_profiler(profiler_.get());
+        pi_.set_profiler(profiler_.get());
+        si_.set_profiler(profiler_.get());
+        ai_.set_profiler(profiler_.get());
+        rsp_.set_profiler(profiler_.get());
+        rdp_.set_profiler(profiler_.get());
+        vi_.set_profiler(profiler_.get());
+    }
+}
+
+void N64System::write_state(StateWriter& writer, bool include_rdram_memory) const
+{
+    cpu_.save_state(writer);
+    rsp_.save_state(writer);
+    rdp_.save_state(writer);
+    rdram_.save_state(writer, include_rdram_memory);
+    mi_.save_state(writer);
+    ri_.save_state(writer);
+    vi_.save_state(writer);
+    ai_.save_state(writer);
+    pi_.save_state(writer);
+    si_.save_state(writer);
+    pif_.save_state(writer);
+    cart_save_.save_state(writer);
+}
+
+// A damaged or truncated state must be caught before read_state starts
+// writing into the machine. Chunks of plain fields are compared in size with
+// what this build writes; the components with RAM images, optional parts or
+// older versions walk their own layout.
+bool N64System::check_state(StateReader& reader) const
+{
+    static constexpr char FIXED_CHUNKS[][5] = {
+        "CPU ", "CP0 ", "CP1 ", "RSP ", "RDP ", "MI  ", "RI  ", "VI  ", "AI  ", "PI  ",
+    };
+
+    StateWriter written;
+    write_state(written, false);
+    StateReader expected;
+    if (!expected.load(written.buffer())) return false;
+
+    for (const auto& tag : FIXED_CHUNKS) {
+        if (!reader.check_chunk(tag, expected)) return false;
+    }
+    return rdram_.check_state(reader) && si_.check_state(reader) && pif_.check_state(reader)
+        && cart_save_.check_state(reader);
+}
+
+void N64System::read_state(StateReader& reader)
+{
+    cpu_.load_state(reader);
+    rsp_.load_state(reader);
+    // Before RDRAM, so the depth cache is bound to the restored Z buffer
+    // when RDRAM invalidates it
+    rdp_.load_state(reader);
+    rdram_.load_state(reader);
+    mi_.load_state(reader);
+    ri_.load_state(reader);
+    vi_.load_state(reader);
+    ai_.load_state(reader);
+    pi_.load_state(reader);
+    si_.load_state(reader);
+    pif_.load_state(reader);
+    cart_save_.load_state(reader);
+    cpu_.cp0().set_mi_interrupt(mi_.check_interrupts());
+}
+
+bool N64System::save_state(const std::string& path) const
+{
+    auto start = std::chrono::steady_clock::now();
+
+    StateWriter writer;
+    write_state(writer, true);
+    if (!writer.save(path)) return false;
+
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    fprintf(stderr, "[STATE] Saved %s (%zu KB) in %.1f ms\n", path.c_str(), writer.size() / 1024, ms);
+    return true;
+}
+
+bool N64System::load_state(const std::string& path)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    StateReader reader;
+    if (!reader.load(path)) return false;
+    if (!check_state(reader)) {
+        fprintf(stderr, "[STATE] %s is incomplete or damaged, nothing was loaded\n", path.c_str());
+        return false;
+    }
+    read_state(reader);
+
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    fprintf(stderr, "[STATE] Loaded %s in %.1f ms\n", path.c_str(), ms);
+    return true;
 }
 
 u32 N64System::boot()
@@ -120,7 +309,10 @@ u32 N64System::boot()
 
 void N64System::poll_input()
 {
-    const bool* keys = SDL_GetKeyboardState(nullptr);
+    // Snapshot taken by the presenter on the main thread
+    vi_.keyboard_state(host_keys_);
+    if (host_keys_.empty()) return;  // headless
+    const u8* keys = host_keys_.data();
     memory::ControllerState state;
 
     if (keys[SDL_SCANCODE_X])      state.buttons |= 0x8000;  // A
@@ -144,15 +336,72 @@ void N64System::poll_input()
     if (keys[SDL_SCANCODE_S]) state.analog_y = -80;
 
     pif_.set_controller_state(state);
+
+    bool save_key = keys[SDL_SCANCODE_F5];
+    bool load_key = keys[SDL_SCANCODE_F7];
+    if ((save_key || load_key) && !state_key_held_) {
+        if (save_key) save_state(state_path_);
+        else load_state(state_path_);
+    }
+    state_key_held_ = save_key || load_key;
+
+    rewind_held_ = keys[SDL_SCANCODE_BACKSPACE];
+}
+
+void N64System::update_rewind()
+{
+    // Rewinding steps back one snapshot per field, so it plays back
+    // rewind_interval_ times faster than it was recorded
+    if (rewind_held_) {
+        std::vector<u8> state;
+        if (rewind_->step_back(state)) {
+            StateReader reader;
+            if (reader.load(std::move(state))) read_state(reader);
+        }
+        rewind_field_ = vi_.fields();
+        return;
+    }
+    if (vi_.fields() - rewind_field_ < rewind_interval_) return;
+    rewind_field_ = vi_.fields();
+
+    StateWriter writer;
+    write_state(writer, false);
+    rewind_->capture(writer.buffer());
 }
 
+// SDL's renderer and event queue belong to the main thread, so the
+// emulation runs on a worker while this thread presents frames
 void N64System::run()
+{
+    std::exception_ptr error;
+    std::thread emulation([this, &error] {
+        try {
+            emulate();
+        } catch (...) {
+            error = std::current_exception();
+        }
+        vi_.stop_presenting();
+    });
+    vi_.present();
+    emulation.join();
+    if (error) std::rethrow_exception(error);
+
+    if (!exit_state_path_.empty()) {
+        save_state(exit_state_path_);
+    }
+    if (profiler_) {
+        profiler_->dump(profile_path_);
+    }
+}
+
+void N64System::emulate()
 {
     u64 event_check_counter = 0;
     u64 total_instructions = 0;
     constexpr u64 EVENT_CHECK_INTERVAL = 10000;
 
     while (true) {
+        if (profiler_) profiler_->set_pc(cpu_.pc());
         u32 cycles = cpu_.execute_next_instruction();
         total_instructions++;
 
@@ -185,13 +434,15 @@ void N64System::run()
         pi_.process_passed_cycles(cycles);
         rdp_.process_passed_cycles(cycles);
         ai_.process_passed_cycles(cycles);
+        si_.process_passed_cycles(cycles);
         cpu_.cp0().set_mi_interrupt(mi_.check_interrupts());
 
         event_check_counter += cycles;
         if (event_check_counter >= EVENT_CHECK_INTERVAL) {
             event_check_counter = 0;
-            if (!vi_.handle_events()) return;
+            if (!vi_.handle_events()) break;
             poll_input();
+            if (rewind_ && vi_.fields() != rewind_field_) update_rewind();
         }
     }
 }
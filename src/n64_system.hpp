@@ -1,12 +1,15 @@
 #pragma once
 
+#include <memory>
 #include <string>
+#include <vector>
 
 // Memory
 #include "memory/memory_constants.hpp"
 #include "memory/rdram.hpp"
 #include "memory/rom.hpp"
 #include "memory/pif.hpp"
+#include "memory/cart_save.hpp"
 #include "memory/memory_map.hpp"
 
 // Interfaces
@@ -24,6 +27,8 @@
 // CPU
 #include "cpu/vr4300.hpp"
 
+#include "rewind_buffer.hpp"
+
 namespace n64 {
 
 constexpr u32 CPU_CLOCK = 93750000;
@@ -34,7 +39,8 @@ public:
     explicit N64System(const std::string& rom_path);
     ~N64System() = default;
 
-    // Main emulation loop
+    // Main emulation loop; runs it on a worker thread and presents frames on
+    // the calling thread, which must be the main thread
     void run();
     
     // Boot the system - loads ROM code into RDRAM
@@ -43,6 +49,10 @@ public:
     // Poll SDL keyboard and update PIF controller state
     void poll_input();
 
+    // Whole-machine save states (format in utils/save_state.hpp)
+    bool save_state(const std::string& path) const;
+    bool load_state(const std::string& path);
+
     // Component accessors (for debugging/testing)
     [[nodiscard]] cpu::VR4300& cpu() { return cpu_; }
     [[nodiscard]] rcp::RSP& rsp() { return rsp_; }
@@ -50,6 +60,14 @@ public:
     [[nodiscard]] memory::MemoryMap& memory() { return memory_map_; }
 
 private:
+    void emulate();
+    void write_state(StateWriter& writer, bool include_rdram_memory) const;
+    // Checks every chunk read_state applies; false leaves nothing to apply
+    [[nodiscard]] bool check_state(StateReader& reader) const;
+    void read_state(StateReader& reader);
+    // Called on each new VI field: records or, while rewinding, steps back
+    void update_rewind();
+
     // ===== Components (order matters for initialization!) =====
     
     // Memory
@@ -62,6 +80,9 @@ private:
     
     // ROM (needs PI)
     memory::ROM rom_;
+
+    // Cartridge SRAM / FlashRAM
+    memory::CartSave cart_save_;
     
     // RDP
     rdp::RDP rdp_;
@@ -83,6 +104,23 @@ private:
     
     // CPU (needs memory map)
     cpu::VR4300 cpu_;
+
+    // F5 saves to / F7 loads from state_path_; STATE_SAVE is written on exit
+    std::string state_path_;
+    std::string exit_state_path_;
+    bool state_key_held_ = false;
+    std::vector<u8> host_keys_;
+
+    // REWIND_MB=<arena size> enables rewind (held Backspace), capturing every
+    // REWIND_INTERVAL fields
+    std::unique_ptr<RewindBuffer> rewind_;
+    u32 rewind_interval_ = 4;
+    u64 rewind_field_ = 0;
+    bool rewind_held_ = false;
+
+    // Set by MEM_PROFILE; the report is written when run() returns
+    std::unique_ptr<memory::AccessProfiler> profiler_;
+    std::string profile_path_;
 };
 
 }
@@ -0,0 +1,57 @@
+#include "coverage_store.hpp"
+
+#include <algorithm>
+
+namespace n64::rdp {
+
+CoverageStore::CoverageStore() {
+    targets_.reserve(MAX_TARGETS);
+    bind(0, 640);
+}
+
+void CoverageStore::bind(u32 addr, u32 width) {
+    size_t plane_words = (static_cast<size_t>(width) * MAX_ROWS + 63) / 64;
+    size_t words = plane_words * 3;
+
+    auto target = std::find_if(targets_.begin(), targets_.end(),
+        [&](const Target& t) { return t.addr == addr && t.width == width; });
+
+    if (target == targets_.end()) {
+        if (targets_.size() == MAX_TARGETS) {
+            // Reuse the least recently bound slot when it is large enough,
+            // otherwise start the arena over
+            auto oldest = std::min_element(targets_.begin(), targets_.end(),
+                [](const Target& a, const Target& b) { return a.last_use < b.last_use; });
+            if (oldest->width >= width) {
+                target = oldest;
+            } else {
+                targets_.clear();
+                arena_used_ = 0;
+            }
+        }
+        if (target == targets_.end()) {
+            if (arena_used_ + words > ARENA_WORDS) {
+                targets_.clear();
+                arena_used_ = 0;
+            }
+            targets_.push_back({addr, width, arena_used_, 0});
+            target = targets_.end() - 1;
+            arena_used_ += words;
+            if (arena_.size() < arena_used_) {
+                arena_.resize(arena_used_);
+            }
+        }
+        target->addr = addr;
+        target->width = width;
+
+        // Fresh targets start fully covered
+        std::fill_n(arena_.begin() + target->offset, words, ~0ull);
+    }
+
+    target->last_use = ++use_counter_;
+    planes_ = arena_.data() + target->offset;
+    plane_words_ = plane_words;
+    pixels_ = width * MAX_ROWS;
+}
+
+} // namespace n64::rdp
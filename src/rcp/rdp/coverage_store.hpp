@@ -0,0 +1,61 @@
+#pragma once
+
+#include "../../utils/types.hpp"
+#include <cstddef>
+#include <vector>
+
+namespace n64::rdp {
+
+// Per-render-target pixel coverage (3 bits per pixel). Every color image gets
+// its own set of three bit planes (bit 0, 1 and 2 of each pixel's coverage),
+// carved from one shared arena and found again by (address, width) when the
+// game switches back to that target. Pixels are addressed the same way as the
+// color image, y * width + x. When the arena is full every target is dropped
+// and allocation starts over.
+class CoverageStore {
+public:
+    static constexpr u32 MAX_ROWS = 512;
+    static constexpr u32 MAX_TARGETS = 16;
+    static constexpr size_t ARENA_WORDS = 1 << 19;
+
+    CoverageStore();
+
+    void bind(u32 addr, u32 width);
+
+    [[nodiscard]] u8 get(u32 index) const {
+        if (index >= pixels_) return 7;
+        const u64* word = planes_ + (index >> 6);
+        u32 bit = index & 63;
+        return ((word[0] >> bit) & 1) | (((word[plane_words_] >> bit) & 1) << 1)
+            | (((word[plane_words_ * 2] >> bit) & 1) << 2);
+    }
+
+    void set(u32 index, u8 cvg) {
+        if (index >= pixels_) return;
+        u64* word = planes_ + (index >> 6);
+        u32 bit = index & 63;
+        for (u32 plane = 0; plane < 3; plane++) {
+            u64& bits = word[plane_words_ * plane];
+            bits = (bits & ~(1ull << bit)) | (static_cast<u64>((cvg >> plane) & 1) << bit);
+        }
+    }
+
+private:
+    struct Target {
+        u32 addr;
+        u32 width;
+        size_t offset;
+        u32 last_use;
+    };
+
+    std::vector<u64> arena_;
+    size_t arena_used_ = 0;
+    std::vector<Target> targets_;
+    u32 use_counter_ = 0;
+
+    u64* planes_ = nullptr;
+    size_t plane_words_ = 0;
+    u32 pixels_ = 0;
+};
+
+} // namespace n64::rdp
@@ -0,0 +1,124 @@
+#include "depth_cache.hpp"
+#include "../../memory/rdram.hpp"
+#include "../../memory/access_profiler.hpp"
+
+#include <algorithm>
+
+namespace n64::rdp {
+
+DepthCache::DepthCache(memory::RDRAM& rdram)
+    : rdram_(rdram)
+{}
+
+DepthCache::~DepthCache() {
+    rdram_.set_write_watch(0, 0, nullptr);
+}
+
+void DepthCache::set_depth_image(u32 addr, u32 width) {
+    if (addr == addr_ && width == width_) return;
+
+    addr_ = addr;
+    width_ = width;
+    blocks_x_ = (width + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    blocks_y_ = 0;
+    block_max_.clear();
+    rdram_.set_write_watch(0, 0, nullptr);
+}
+
+// The grid (and the watched range) grows with the lowest row drawn so far
+void DepthCache::ensure_rows(u32 block_rows) {
+    if (block_rows <= blocks_y_) return;
+
+    blocks_y_ = block_rows;
+    block_max_.resize(blocks_x_ * blocks_y_, INVALID);
+    rdram_.set_write_watch(addr_, width_ * blocks_y_ * BLOCK_SIZE * 2,
+        [this](u32 address, u32 length) { invalidate(address, length); });
+}
+
+void DepthCache::invalidate(u32 address, u32 length) {
+    if (own_write_) return;
+
+    u32 first = (std::max(address, addr_) - addr_) / 2;
+    u32 last = (address + length - 1 - addr_) / 2;
+    last = std::min(last, width_ * blocks_y_ * BLOCK_SIZE - 1);
+    if (first > last) return;
+
+    u32 first_row = first / width_;
+    u32 last_row = last / width_;
+    for (u32 y = first_row; y <= last_row; y++) {
+        u32 x0 = (y == first_row) ? first % width_ : 0;
+        u32 x1 = (y == last_row) ? last % width_ : width_ - 1;
+        u32* row = &block_max_[(y / BLOCK_SIZE) * blocks_x_];
+        std::fill(row + x0 / BLOCK_SIZE, row + x1 / BLOCK_SIZE + 1, INVALID);
+    }
+}
+
+u32 DepthCache::refresh(u32 block_x, u32 block_y) {
+    u32 x0 = block_x * BLOCK_SIZE;
+    u32 count = std::min(BLOCK_SIZE, width_ - x0);
+    u16 bound = 0;
+    for (u32 y = block_y * BLOCK_SIZE; y < (block_y + 1) * BLOCK_SIZE; y++) {
+        u32 row_addr = addr_ + (y * width_ + x0) * 2;
+        for (u32 x = 0; x < count; x++) {
+            bound = std::max(bound, rdram_.read_memory<u16>(row_addr + x * 2));
+        }
+    }
+    block_max_[block_y * blocks_x_ + block_x] = bound;
+    if (profiler_) {
+        profiler_->record_dma(memory::AccessProfiler::Dma::DPDepth,
+                              addr_ + (block_y * BLOCK_SIZE * width_ + x0) * 2, count * 2, false,
+                              BLOCK_SIZE, (width_ - count) * 2);
+    }
+    return bound;
+}
+
+bool DepthCache::span_occluded(s32 y, s32 x_start, s32 x_end, u16 nearest_z) {
+    if (width_ == 0 || y < 0 || x_start < 0 || x_end > static_cast<s32>(width_)) return false;
+
+    u32 block_y = y / BLOCK_SIZE;
+    ensure_rows(block_y + 1);
+
+    u32* row = &block_max_[block_y * blocks_x_];
+    for (u32 block_x = x_start / BLOCK_SIZE; block_x <= (x_end - 1) / BLOCK_SIZE; block_x++) {
+        u32 bound = row[block_x];
+        if (bound == INVALID) {
+            bound = refresh(block_x, block_y);
+        }
+        if (nearest_z < bound) return false;
+    }
+    return true;
+}
+
+void DepthCache::raise_bound(u32 pixel, u16 z) {
+    u32 block_y = pixel / width_ / BLOCK_SIZE;
+    if (block_y >= blocks_y_) return;
+
+    u32& bound = block_max_[block_y * blocks_x_ + (pixel % width_) / BLOCK_SIZE];
+    if (bound != INVALID && z > bound) {
+        bound = z;
+    }
+}
+
+void DepthCache::store(u32 pixel, u16 z) {
+    own_write_ = true;
+    rdram_.write_memory<u16>(addr_ + pixel * 2, z);
+    own_write_ = false;
+    if (profiler_) profiler_->record_dma(memory::AccessProfiler::Dma::DPDepth, addr_ + pixel * 2, 2, true);
+    if (width_ != 0) {
+        raise_bound(pixel, z);
+    }
+}
+
+void DepthCache::store(u32 pixel, const u8* z_bytes, u32 count) {
+    own_write_ = true;
+    rdram_.write_block(addr_ + pixel * 2, z_bytes, count * 2);
+    own_write_ = false;
+    if (profiler_) profiler_->record_dma(memory::AccessProfiler::Dma::DPDepth, addr_ + pixel * 2, count * 2, true);
+    if (width_ != 0) {
+        for (u32 i = 0; i < count; i++) {
+            raise_bound(pixel + i, (z_bytes[i * 2] << 8) | z_bytes[i * 2 + 1]);
+        }
+    }
+}
+
+} // namespace n64::rdp
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "../../utils/types.hpp"
+#include <vector>
+
+namespace n64::memory {
+class RDRAM;
+class AccessProfiler;
+}
+
+namespace n64::rdp {
+
+// Coarse max-depth cache over the current depth image, one entry per 8x8
+// pixel block. An entry is an upper bound of the Z values stored in its block,
+// so a span whose nearest Z is not below every covered bound fails the depth
+// compare on all of its pixels. The RDP stores Z through this class to keep
+// bounds current; any other write into the depth image (CPU, DMA,
+// Fill_Rectangle) invalidates the touched blocks, which are refreshed from
+// RDRAM on the next query.
+class DepthCache {
+public:
+    static constexpr u32 BLOCK_SIZE = 8;
+
+    explicit DepthCache(memory::RDRAM& rdram);
+    ~DepthCache();
+
+    DepthCache(const DepthCache&) = delete;
+    DepthCache& operator=(const DepthCache&) = delete;
+
+    void set_depth_image(u32 addr, u32 width);
+    // Reports refresh reads and Z stores as RDP depth traffic
+    void set_profiler(memory::AccessProfiler* profiler) { profiler_ = profiler; }
+
+    // True when every pixel of row y in [x_start, x_end) holds a Z <= nearest_z
+    [[nodiscard]] bool span_occluded(s32 y, s32 x_start, s32 x_end, u16 nearest_z);
+
+    // Z writes issued by the RDP (big-endian bytes, count pixels from pixel index)
+    void store(u32 pixel, u16 z);
+    void store(u32 pixel, const u8* z_bytes, u32 count);
+
+private:
+    static constexpr u32 INVALID = 0xFFFFFFFF;
+
+    void ensure_rows(u32 block_rows);
+    void invalidate(u32 address, u32 length);
+    [[nodiscard]] u32 refresh(u32 block_x, u32 block_y);
+    void raise_bound(u32 pixel, u16 z);
+
+    memory::RDRAM& rdram_;
+    memory::AccessProfiler* profiler_ = nullptr;
+    u32 addr_ = 0;
+    u32 width_ = 0;
+    u32 blocks_x_ = 0;
+    u32 blocks_y_ = 0;
+    bool own_write_ = false;
+    std::vector<u32> block_max_;
+};
+
+} // namespace n64::rdp
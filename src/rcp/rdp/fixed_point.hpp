@@ -0,0 +1,61 @@
+#pragma once
+
+#include "../../utils/types.hpp"
+#include <algorithm>
+
+namespace n64::rdp {
+
+// Lean fixed-point value for the rasterizer inner loops. Every format is held
+// as S15.16 in a plain s32 (same layout as FixedPointFloat::raw()); the command
+// field format only lives in the template arguments, where it drives decoding
+// and the integer() clamp. Arithmetic wraps instead of throwing.
+template <u8 IntBits, u8 FracBits, bool Signed = true>
+struct FixedPoint {
+    static_assert(IntBits >= 1 && IntBits <= 16 && FracBits <= 16, "format must fit S15.16");
+
+    s32 raw;
+
+    [[nodiscard]] static constexpr FixedPoint from_raw(s32 value) { return {value}; }
+
+    [[nodiscard]] static constexpr FixedPoint from_fields(u32 int_part, u32 frac_part) {
+        s32 integer = Signed ? sign_extend_n(int_part, IntBits) : static_cast<s32>(int_part);
+        u32 fraction = (frac_part << (16 - FracBits)) & 0xFFFF;
+        return {static_cast<s32>((static_cast<u32>(integer) << 16) | fraction)};
+    }
+
+    [[nodiscard]] constexpr s32 integer() const {
+        constexpr s32 min_val = Signed ? -(1 << (IntBits - 1)) : 0;
+        constexpr s32 max_val = Signed ? (1 << (IntBits - 1)) - 1 : (1 << IntBits) - 1;
+        return std::clamp(raw >> 16, min_val, max_val);
+    }
+    [[nodiscard]] constexpr u16 frac() const { return static_cast<u16>(raw & 0xFFFF); }
+
+    template <u8 I, u8 F, bool S>
+    constexpr FixedPoint& operator+=(FixedPoint<I, F, S> rhs) {
+        raw = static_cast<s32>(static_cast<u32>(raw) + static_cast<u32>(rhs.raw));
+        return *this;
+    }
+
+    template <u8 I, u8 F, bool S>
+    [[nodiscard]] constexpr FixedPoint operator+(FixedPoint<I, F, S> rhs) const {
+        FixedPoint result = *this;
+        result += rhs;
+        return result;
+    }
+
+    [[nodiscard]] constexpr FixedPoint operator*(s32 scalar) const {
+        return {static_cast<s32>(static_cast<u32>(raw) * static_cast<u32>(scalar))};
+    }
+
+    [[nodiscard]] constexpr FixedPoint operator>>(int shift) const { return {raw >> shift}; }
+};
+
+// Command field formats
+using EdgeY     = FixedPoint<12, 2>;    // triangle YL/YM/YH, s11.2
+using EdgeX     = FixedPoint<12, 16>;   // triangle XL/XH/XM, s11.16
+using EdgeSlope = FixedPoint<14, 16>;   // triangle DxDy, s13.16
+using Attribute = FixedPoint<16, 16>;   // shade/texture/z coefficients, s15.16
+using TexCoord  = FixedPoint<11, 5>;    // texture rectangle S/T, s10.5
+using TexSlope  = FixedPoint<6, 10>;    // texture rectangle DsDx/DtDy, s5.10
+
+} // namespace n64::rdp
@@ -21,6 +21,7 @@ namespace n64::rdp {
 // Phase 11 - 2-cycle mode & combiner: DONE (COMBINED, TEXEL1, LOD_FRAC, PRIM_LOD_FRAC, KEY_CENTER, KEY_SCALE)
 // Phase 12 - Alpha pipeline: DONE (Alpha compare, alpha coverage, cvg_dest modes, chroma key)
 // Phase 13 - Dithering: DONE (RGB + alpha dither with Bayer/magic square/noise matrices)
+// Phase 14 - TMEM loads: DONE (row-granular copies, DXT odd-row word swap, TLUT quadruplication)
 //
 // Remaining work:
 // TODO: Combiner 9-bit overflow precision (special_9bit_clamptable, inter-cycle 9-bit passing)
@@ -28,7 +29,6 @@ namespace n64::rdp {
 // TODO: Texture LOD / detail / sharpen (lod_fraction calculation, tile level selection)
 // TODO: Anti-aliasing (proper sub-pixel coverage, blender AA integration)
 // TODO: Fog blending (shade alpha as fog factor -- may already work via blender wiring)
-// TODO: DXT row-swapping in load_block (odd-row byte-swap for dual-bank TMEM)
 // TODO: Framebuffer 4b/8b write/read support
 // TODO: Sub-pixel coverage (4x4 sub-pixel grid instead of current heuristic)
 // TODO: XBUS mode (commands from RSP DMEM)
@@ -49,6 +49,13 @@ RDP::RDP(memory::RDRAM& rdram, n64::interfaces::MI& mi)
     , test_mode_{}
     , buftest_addr_{}
     , buftest_data_{}
+    , color_image_{}
+    , tiles_{}
+    , depth_cache_(rdram)
+    , texture_image_{}
+    , color_combiner_{}
+    , blender_{}
+    , tmem_{}
 {
     command_table_.fill(&RDP::nop);
 
@@ -123,6 +130,10 @@ u32 RDP::read_register(u32 address) const {
 }
 
 void RDP::write_register(u32 address, u32 value) {
+    if (trace_) {
+        trace_->record_register(address, value);
+    }
+
     switch (address) {
         case DPC_START:
             start_.raw = value & 0x00FFFFF8;  // 24-bit, 64-bit aligned
@@ -135,6 +146,9 @@ void RDP::write_register(u32 address, u32 value) {
                 status_.start_pending = 0;
             }
             process_command_list();
+            if (trace_) {
+                trace_->end_list();
+            }
             break;
         case DPC_STATUS: {
             // Clear counters
@@ -170,6 +184,9 @@ void RDP::process_command_list() {
         "Set_Fog_Color","Set_Blend_Color","Set_Prim_Color","Set_Env_Color","Set_Combine","Set_Tex_Image","Set_Z_Image","Set_Color_Image",
     };
 #endif
+    if (current_.raw < end_.raw) {
+        record_traffic(memory::AccessProfiler::Dma::DPCommand, current_.raw, end_.raw - current_.raw, false);
+    }
     while (current_.raw < end_.raw) {
         u64 command = rdram_.read_memory<u64>(current_.raw);
         u8 command_id = (command >> 56) & 0x3F;
@@ -180,6 +197,165 @@ void RDP::process_command_list() {
     status_.dma_busy = 0;
 }
 
+u32 RDP::primitive_cost(u32 pixel_count) {
+    pixels_drawn_ += pixel_count;
+    stats_.pixels_covered += pixel_count;
+    return std::max(pixel_count, 8u);
+}
+
+void RDP::count_primitive(u32& kind) {
+    kind++;
+    stats_.cycle_type_primitives[cycle_type_]++;
+}
+
+void RDP::end_frame() {
+    if (stats_log_) {
+        stats_log_->write(stats_);
+    }
+    last_frame_stats_ = stats_;
+    stats_ = FrameStats{};
+    stats_.frame = last_frame_stats_.frame + 1;
+}
+
+void RDP::start_trace(const std::string& path) {
+    trace_ = std::make_unique<TraceWriter>(rdram_, path);
+    if (!trace_->is_open()) {
+        trace_.reset();
+    }
+}
+
+void RDP::set_profiler(memory::AccessProfiler* profiler) {
+    profiler_ = profiler;
+    depth_cache_.set_profiler(profiler);
+}
+
+void RDP::start_stats_log(const std::string& path) {
+    stats_log_ = std::make_unique<StatsWriter>(path);
+    if (!stats_log_->is_open()) {
+        stats_log_.reset();
+    }
+}
+
+void RDP::save_state(StateWriter& writer) const {
+    writer.begin_chunk("RDP ", 1);
+    writer.write(start_);
+    writer.write(end_);
+    writer.write(current_);
+    writer.write(status_);
+    writer.write(clock_);
+    writer.write(buf_busy_);
+    writer.write(pipe_busy_);
+    writer.write(tmem_busy_);
+    writer.write(tbist_);
+    writer.write(test_mode_);
+    writer.write(buftest_addr_);
+    writer.write(buftest_data_);
+    writer.write(color_image_);
+    writer.write(scissor_);
+    writer.write(scissor_enable_);
+    writer.write(fill_color_);
+    writer.write(tiles_);
+    writer.write(tile_index_);
+    writer.write(atomic_prim_);
+    writer.write(cycle_type_);
+    writer.write(perspective_texture_enable_);
+    writer.write(detail_textures_enable_);
+    writer.write(sharpen_textures_enable_);
+    writer.write(texture_lod_enable_);
+    writer.write(tlut_enable_);
+    writer.write(tlut_type_);
+    writer.write(sample_type_);
+    writer.write(mid_texel_);
+    writer.write(bi_lerp_0_);
+    writer.write(bi_lerp_1_);
+    writer.write(convert_one_);
+    writer.write(key_enable_);
+    writer.write(z_mode_);
+    writer.write(image_read_enable_);
+    writer.write(antialiasing_enable_);
+    writer.write(alpha_compare_enable_);
+    writer.write(alpha_cvg_select_);
+    writer.write(cvg_x_alpha_);
+    writer.write(color_on_cvg_);
+    writer.write(cvg_dest_);
+    writer.write(z_update_enable_);
+    writer.write(z_compare_enable_);
+    writer.write(z_source_select_);
+    writer.write(z_buffer_addr_);
+    writer.write(z_prim_depth_);
+    writer.write(dz_prim_depth_);
+    writer.write(rgb_dither_sel_);
+    writer.write(alpha_dither_sel_);
+    writer.write(dither_alpha_enable_);
+    writer.write(texture_image_);
+    writer.write(color_combiner_);
+    writer.write(blender_);
+    writer.write(tmem_);
+    writer.write(combine_mode_);
+    writer.end_chunk();
+}
+
+void RDP::load_state(StateReader& reader) {
+    if (!reader.open_chunk("RDP ", 1)) return;
+    reader.read(start_);
+    reader.read(end_);
+    reader.read(current_);
+    reader.read(status_);
+    reader.read(clock_);
+    reader.read(buf_busy_);
+    reader.read(pipe_busy_);
+    reader.read(tmem_busy_);
+    reader.read(tbist_);
+    reader.read(test_mode_);
+    reader.read(buftest_addr_);
+    reader.read(buftest_data_);
+    reader.read(color_image_);
+    reader.read(scissor_);
+    reader.read(scissor_enable_);
+    reader.read(fill_color_);
+    reader.read(tiles_);
+    reader.read(tile_index_);
+    reader.read(atomic_prim_);
+    reader.read(cycle_type_);
+    reader.read(perspective_texture_enable_);
+    reader.read(detail_textures_enable_);
+    reader.read(sharpen_textures_enable_);
+    reader.read(texture_lod_enable_);
+    reader.read(tlut_enable_);
+    reader.read(tlut_type_);
+    reader.read(sample_type_);
+    reader.read(mid_texel_);
+    reader.read(bi_lerp_0_);
+    reader.read(bi_lerp_1_);
+    reader.read(convert_one_);
+    reader.read(key_enable_);
+    reader.read(z_mode_);
+    reader.read(image_read_enable_);
+    reader.read(antialiasing_enable_);
+    reader.read(alpha_compare_enable_);
+    reader.read(alpha_cvg_select_);
+    reader.read(cvg_x_alpha_);
+    reader.read(color_on_cvg_);
+    reader.read(cvg_dest_);
+    reader.read(z_update_enable_);
+    reader.read(z_compare_enable_);
+    reader.read(z_source_select_);
+    reader.read(z_buffer_addr_);
+    reader.read(z_prim_depth_);
+    reader.read(dz_prim_depth_);
+    reader.read(rgb_dither_sel_);
+    reader.read(alpha_dither_sel_);
+    reader.read(dither_alpha_enable_);
+    reader.read(texture_image_);
+    reader.read(color_combiner_);
+    reader.read(blender_);
+    reader.read(tmem_);
+    reader.read(combine_mode_);
+
+    depth_cache_.set_depth_image(z_buffer_addr_, color_image_.width);
+    coverage_.bind(color_image_.addr, color_image_.width);
+}
+
 void RDP::process_passed_cycles(u32 cycles) {
     (void)cycles;
 }
@@ -196,6 +372,7 @@ u32 RDP::sync_tile(u64 command) { return 8; }
 
 u32 RDP::sync_full(u64 command) {
     mi_.set_interrupt(interfaces::MI_INTERRUPT_BITS::MI_INTERRUPT_DP);
+    end_frame();
     return 8;
 }
 
@@ -360,6 +537,10 @@ u32 RDP::set_environment_color(u64 command) {
 
 u32 RDP::set_combine_mode(u64 command) {
     color_combiner_.set_combine_mode(command);
+    if (command != combine_mode_) {
+        stats_.combiner_switches++;
+        combine_mode_ = command;
+    }
     RDP_LOG_STATE("combine: A_rgb0=%u B_rgb0=%u C_rgb0=%u D_rgb0=%u A_a0=%u B_a0=%u C_a0=%u D_a0=%u "
         "A_rgb1=%u B_rgb1=%u C_rgb1=%u D_rgb1=%u A_a1=%u B_a1=%u C_a1=%u D_a1=%u",
         (u32)get_bits(command, 55, 52), (u32)get_bits(command, 31, 28),
@@ -389,6 +570,7 @@ u32 RDP::set_texture_image(u64 command) {
 
 u32 RDP::set_depth_image(u64 command) { 
     z_buffer_addr_ = get_bits(command, 24, 0);
+    depth_cache_.set_depth_image(z_buffer_addr_, color_image_.width);
     RDP_LOG_STATE("z_image: addr=0x%06X", z_buffer_addr_);
     return 8;
 }
@@ -405,10 +587,8 @@ u32 RDP::set_color_image(u64 command) {
             fn[(u8)color_image_.format], sn[(u8)color_image_.size], color_image_.width, color_image_.addr);
     }
 
-    u32 needed = color_image_.width * 240;
-    if (needed > cvg_buffer_.size()) {
-        cvg_buffer_.resize(needed, 7);
-    }
+    depth_cache_.set_depth_image(z_buffer_addr_, color_image_.width);
+    coverage_.bind(color_image_.addr, color_image_.width);
     return 8;
 }
 
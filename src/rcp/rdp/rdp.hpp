@@ -1,12 +1,21 @@
 #pragma once
 
 #include "../../utils/types.hpp"
+#include "../../utils/save_state.hpp"
+#include "../../memory/access_profiler.hpp"
 #include "rdp_registers.hpp"
 #include <array>
+#include <memory>
+#include <string>
 #include <vector>
 #include "color_combiner.hpp"
 #include "blender.hpp"
 #include "fixed_point_float.hpp"
+#include "fixed_point.hpp"
+#include "depth_cache.hpp"
+#include "coverage_store.hpp"
+#include "rdp_trace.hpp"
+#include "rdp_stats.hpp"
 
 namespace n64::memory {
 class RDRAM;
@@ -103,6 +112,27 @@ public:
 
     void process_passed_cycles(u32 cycles);
 
+    // Records every command list and its RDRAM inputs (see rdp_trace.hpp).
+    // Must be started before the first list for the trace to replay.
+    void start_trace(const std::string& path);
+
+    // Pixels covered by primitives since construction
+    [[nodiscard]] u64 pixels_drawn() const { return pixels_drawn_; }
+
+    // Per-frame counters: the frame in progress and the last completed one.
+    // With a stats log started, every completed frame is also written as CSV.
+    [[nodiscard]] const FrameStats& frame_stats() const { return stats_; }
+    [[nodiscard]] const FrameStats& last_frame_stats() const { return last_frame_stats_; }
+    void start_stats_log(const std::string& path);
+
+    // Reports command fetches, texture loads and color/depth image traffic
+    void set_profiler(memory::AccessProfiler* profiler);
+
+    // Registers and command state. Coverage is not saved: it only carries
+    // edge information between primitives of the same frame.
+    void save_state(StateWriter& writer) const;
+    void load_state(StateReader& reader);
+
     // Accessors
     [[nodiscard]] const DPCStatus& status() const { return status_; }
 
@@ -133,6 +163,10 @@ private:
     u32 fill_rectangle(u64 command);
     u32 copy_rectangle(const Rectangle& copy_rect);
     u32 fill_rectangle(const Rectangle& fill_rect);
+    bool copy_texture_rectangle(const Rectangle& rect, u8 tile_index,
+                                TexCoord s, TexCoord t,
+                                TexSlope s_inc, TexSlope dtdy,
+                                u32& pixel_count);
     u32 set_fill_color(u64 command);
     u32 set_fog_color(u64 command);
     u32 set_blend_color(u64 command);
@@ -144,12 +178,16 @@ private:
     u32 set_color_image(u64 command);
 
     void process_command_list();
+    u32 primitive_cost(u32 pixel_count);
+    void count_primitive(u32& kind);
+    void end_frame();
 
     // Helper functions
     [[nodiscard]] float bytes_per_pixel(Size size) const;
 
     template<typename T>
     [[nodiscard]] T read_tmem(u32 addr) const;
+    void load_tmem_row(u32 rdram_addr, u32 tmem_addr, u32 length, bool odd_row);
 
     [[nodiscard]] Color fetch_pixel_tmem(u32 addr, Size size, Format format, bool odd_texel, u8 palette = 0) const;
     void write_pixel_framebuffer(u32 addr, const Color& color);
@@ -160,8 +198,15 @@ private:
                        s32 tex_s, s32 tex_t,
                        const Color& shade, s32 z_depth,
                        u8 pixel_cvg,
-                       bool has_texture, bool has_shade,
+                       bool has_texture, bool has_shade, bool depth_tested,
                        int& pix_log_cnt);
+    bool depth_test_span(s32 y, s32 x_start, s32 x_end, Attribute z, Attribute dzdx);
+    bool span_behind_depth(s32 y, s32 x_start, s32 x_end, Attribute z, Attribute dzdx);
+
+    void record_traffic(memory::AccessProfiler::Dma kind, u32 address, u32 length, bool is_write,
+                        u32 rows = 1, u32 skip = 0) const {
+        if (profiler_) profiler_->record_dma(kind, address, length, is_write, rows, skip);
+    }
 
     void apply_alpha_dither(s32 x, s32 y, Color& color);
     void apply_rgb_dither(s32 x, s32 y, Color& color);
@@ -224,12 +269,12 @@ private:
 
     // Alpha coverage state
     bool apply_alpha_coverage(u8 pixel_cvg, u32 cvg_index, Color& color);
-    u8 compute_pixel_cvg(s32 x, FixedPointFloat x_left, FixedPointFloat x_right) const;
+    u8 compute_pixel_cvg(s32 x, EdgeX x_left, EdgeX x_right) const;
     u8 alpha_cvg_select_ = 0;
     bool cvg_x_alpha_ = false;
     bool color_on_cvg_ = false;
     u8 cvg_dest_ = 0;
-    std::vector<u8> cvg_buffer_ = std::vector<u8>(640 * 480, 7);
+    CoverageStore coverage_;
 
     // Z-buffer state
     bool z_update_enable_ = false;
@@ -238,6 +283,9 @@ private:
     u32 z_buffer_addr_ = 0;
     u16 z_prim_depth_ = 0;
     u16 dz_prim_depth_ = 0;
+    // Visibility of each pixel of the current triangle span (depth_test_span)
+    std::vector<u8> span_depth_mask_;
+    DepthCache depth_cache_;
 
     // Dither state and utilitires
     u8 rgb_dither_sel_ = 0;
@@ -267,6 +315,18 @@ private:
 
     // Texture memory
     std::array<u8, 4096> tmem_;
+
+    std::unique_ptr<TraceWriter> trace_;
+    memory::AccessProfiler* profiler_ = nullptr;
+    u64 pixels_drawn_ = 0;
+
+    FrameStats stats_;
+    FrameStats last_frame_stats_;
+    std::unique_ptr<StatsWriter> stats_log_;
+    u64 combine_mode_ = 0;
+
+    // Scratch row used by the span fast paths (fill pattern, copy-mode blits)
+    std::vector<u8> span_buffer_;
 };
 
 } // namespace n64::rdp
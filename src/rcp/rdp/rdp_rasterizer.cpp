@@ -3,6 +3,7 @@
 #include "../../memory/rdram.hpp"
 
 #include <algorithm>
+#include <cstring>
 
 namespace n64::rdp {
 
@@ -12,39 +13,40 @@ u32 RDP::triangle(u64 command) {
     bool has_zbuffer = get_bit(command, 56);
     bool l_major = get_bit(command, 55);
     u8 tile_index = get_bits(command, 50, 48);
-    FixedPointFloat y_low(get_bits(command, 45, 34), get_bits(command, 33, 32), 12, 2, true);
-    FixedPointFloat y_mid(get_bits(command, 29, 18), get_bits(command, 17, 16), 12, 2, true);
-    FixedPointFloat y_high(get_bits(command, 13, 2), get_bits(command, 1, 0), 12, 2, true);
+    auto y_low = EdgeY::from_fields(get_bits(command, 45, 34), get_bits(command, 33, 32));
+    auto y_mid = EdgeY::from_fields(get_bits(command, 29, 18), get_bits(command, 17, 16));
+    auto y_high = EdgeY::from_fields(get_bits(command, 13, 2), get_bits(command, 1, 0));
 
     command = rdram_.read_memory<u64>(current_.raw);
     current_.raw += 8;
 
-    FixedPointFloat x_low(get_bits(command, 59, 48), get_bits(command, 47, 32), 12, 16, true);
-    FixedPointFloat dx_low_dy(get_bits(command, 29, 16), get_bits(command, 15, 0), 14, 16, true);
+    auto x_low = EdgeX::from_fields(get_bits(command, 59, 48), get_bits(command, 47, 32));
+    auto dx_low_dy = EdgeSlope::from_fields(get_bits(command, 29, 16), get_bits(command, 15, 0));
 
     command = rdram_.read_memory<u64>(current_.raw);
     current_.raw += 8;
 
-    FixedPointFloat x_high(get_bits(command, 59, 48), get_bits(command, 47, 32), 12, 16, true);
-    FixedPointFloat dx_high_dy(get_bits(command, 29, 16), get_bits(command, 15, 0), 14, 16, true);
+    auto x_high = EdgeX::from_fields(get_bits(command, 59, 48), get_bits(command, 47, 32));
+    auto dx_high_dy = EdgeSlope::from_fields(get_bits(command, 29, 16), get_bits(command, 15, 0));
 
     command = rdram_.read_memory<u64>(current_.raw);
     current_.raw += 8;
 
-    FixedPointFloat x_mid(get_bits(command, 59, 48), get_bits(command, 47, 32), 12, 16, true);
-    FixedPointFloat dx_mid_dy(get_bits(command, 29, 16), get_bits(command, 15, 0), 14, 16, true);
+    auto x_mid = EdgeX::from_fields(get_bits(command, 59, 48), get_bits(command, 47, 32));
+    auto dx_mid_dy = EdgeSlope::from_fields(get_bits(command, 29, 16), get_bits(command, 15, 0));
 
     RDP_LOG_PRIM("triangle: yH=%d yM=%d yL=%d tile=%u shade=%d tex=%d zbuf=%d lmaj=%d",
         y_high.integer(), y_mid.integer(), y_low.integer(), tile_index,
         has_shade, has_texture, has_zbuffer, l_major);
 
+    count_primitive(stats_.triangles);
     u32 pixel_count = 0;
     [[maybe_unused]] int pix_log_cnt = 0;
 
-    FixedPointFloat r, g, b, a;
-    FixedPointFloat DrDx, DgDx, DbDx, DaDx;
-    FixedPointFloat DrDe, DgDe, DbDe, DaDe;
-    FixedPointFloat DrDy, DgDy, DbDy, DaDy;
+    Attribute r{}, g{}, b{}, a{};
+    Attribute DrDx{}, DgDx{}, DbDx{}, DaDx{};
+    Attribute DrDe{}, DgDe{}, DbDe{}, DaDe{};
+    Attribute DrDy{}, DgDy{}, DbDy{}, DaDy{};
 
     if (has_shade) {
         u64 word_0 = rdram_.read_memory<u64>(current_.raw); current_.raw += 8;
@@ -56,31 +58,31 @@ u32 RDP::triangle(u64 command) {
         u64 word_6 = rdram_.read_memory<u64>(current_.raw); current_.raw += 8;
         u64 word_7 = rdram_.read_memory<u64>(current_.raw); current_.raw += 8;
 
-        r = FixedPointFloat(get_bits(word_0, 63, 48), get_bits(word_2, 63, 48), 16, 16, true);
-        g = FixedPointFloat(get_bits(word_0, 47, 32), get_bits(word_2, 47, 32), 16, 16, true);
-        b = FixedPointFloat(get_bits(word_0, 31, 16), get_bits(word_2, 31, 16), 16, 16, true);
-        a = FixedPointFloat(get_bits(word_0, 15,  0), get_bits(word_2, 15,  0), 16, 16, true);
-
-        DrDx = FixedPointFloat(get_bits(word_1, 63, 48), get_bits(word_3, 63, 48), 16, 16, true);
-        DgDx = FixedPointFloat(get_bits(word_1, 47, 32), get_bits(word_3, 47, 32), 16, 16, true);
-        DbDx = FixedPointFloat(get_bits(word_1, 31, 16), get_bits(word_3, 31, 16), 16, 16, true);
-        DaDx = FixedPointFloat(get_bits(word_1, 15,  0), get_bits(word_3, 15,  0), 16, 16, true);
-
-        DrDe = FixedPointFloat(get_bits(word_4, 63, 48), get_bits(word_6, 63, 48), 16, 16, true);
-        DgDe = FixedPointFloat(get_bits(word_4, 47, 32), get_bits(word_6, 47, 32), 16, 16, true);
-        DbDe = FixedPointFloat(get_bits(word_4, 31, 16), get_bits(word_6, 31, 16), 16, 16, true);
-        DaDe = FixedPointFloat(get_bits(word_4, 15,  0), get_bits(word_6, 15,  0), 16, 16, true);
-
-        DrDy = FixedPointFloat(get_bits(word_5, 63, 48), get_bits(word_7, 63, 48), 16, 16, true);
-        DgDy = FixedPointFloat(get_bits(word_5, 47, 32), get_bits(word_7, 47, 32), 16, 16, true);
-        DbDy = FixedPointFloat(get_bits(word_5, 31, 16), get_bits(word_7, 31, 16), 16, 16, true);
-        DaDy = FixedPointFloat(get_bits(word_5, 15,  0), get_bits(word_7, 15,  0), 16, 16, true);
+        r = Attribute::from_fields(get_bits(word_0, 63, 48), get_bits(word_2, 63, 48));
+        g = Attribute::from_fields(get_bits(word_0, 47, 32), get_bits(word_2, 47, 32));
+        b = Attribute::from_fields(get_bits(word_0, 31, 16), get_bits(word_2, 31, 16));
+        a = Attribute::from_fields(get_bits(word_0, 15,  0), get_bits(word_2, 15,  0));
+
+        DrDx = Attribute::from_fields(get_bits(word_1, 63, 48), get_bits(word_3, 63, 48));
+        DgDx = Attribute::from_fields(get_bits(word_1, 47, 32), get_bits(word_3, 47, 32));
+        DbDx = Attribute::from_fields(get_bits(word_1, 31, 16), get_bits(word_3, 31, 16));
+        DaDx = Attribute::from_fields(get_bits(word_1, 15,  0), get_bits(word_3, 15,  0));
+
+        DrDe = Attribute::from_fields(get_bits(word_4, 63, 48), get_bits(word_6, 63, 48));
+        DgDe = Attribute::from_fields(get_bits(word_4, 47, 32), get_bits(word_6, 47, 32));
+        DbDe = Attribute::from_fields(get_bits(word_4, 31, 16), get_bits(word_6, 31, 16));
+        DaDe = Attribute::from_fields(get_bits(word_4, 15,  0), get_bits(word_6, 15,  0));
+
+        DrDy = Attribute::from_fields(get_bits(word_5, 63, 48), get_bits(word_7, 63, 48));
+        DgDy = Attribute::from_fields(get_bits(word_5, 47, 32), get_bits(word_7, 47, 32));
+        DbDy = Attribute::from_fields(get_bits(word_5, 31, 16), get_bits(word_7, 31, 16));
+        DaDy = Attribute::from_fields(get_bits(word_5, 15,  0), get_bits(word_7, 15,  0));
     }
 
-    FixedPointFloat s, t, w;
-    FixedPointFloat DsDx, DtDx, DwDx;
-    FixedPointFloat DsDe, DtDe, DwDe;
-    FixedPointFloat DsDy, DtDy, DwDy;
+    Attribute s{}, t{}, w{};
+    Attribute DsDx{}, DtDx{}, DwDx{};
+    Attribute DsDe{}, DtDe{}, DwDe{};
+    Attribute DsDy{}, DtDy{}, DwDy{};
 
     if (has_texture) {
         u64 word_0 = rdram_.read_memory<u64>(current_.raw); current_.raw += 8;
@@ -92,82 +94,116 @@ u32 RDP::triangle(u64 command) {
         u64 word_6 = rdram_.read_memory<u64>(current_.raw); current_.raw += 8;
         u64 word_7 = rdram_.read_memory<u64>(current_.raw); current_.raw += 8;
 
-        s    = FixedPointFloat(get_bits(word_0, 63, 48), get_bits(word_2, 63, 48), 16, 16, true);
-        t    = FixedPointFloat(get_bits(word_0, 47, 32), get_bits(word_2, 47, 32), 16, 16, true);
-        w    = FixedPointFloat(get_bits(word_0, 31, 16), get_bits(word_2, 31, 16), 16, 16, true);
+        s    = Attribute::from_fields(get_bits(word_0, 63, 48), get_bits(word_2, 63, 48));
+        t    = Attribute::from_fields(get_bits(word_0, 47, 32), get_bits(word_2, 47, 32));
+        w    = Attribute::from_fields(get_bits(word_0, 31, 16), get_bits(word_2, 31, 16));
 
-        DsDx = FixedPointFloat(get_bits(word_1, 63, 48), get_bits(word_3, 63, 48), 16, 16, true);
-        DtDx = FixedPointFloat(get_bits(word_1, 47, 32), get_bits(word_3, 47, 32), 16, 16, true);
-        DwDx = FixedPointFloat(get_bits(word_1, 31, 16), get_bits(word_3, 31, 16), 16, 16, true);
+        DsDx = Attribute::from_fields(get_bits(word_1, 63, 48), get_bits(word_3, 63, 48));
+        DtDx = Attribute::from_fields(get_bits(word_1, 47, 32), get_bits(word_3, 47, 32));
+        DwDx = Attribute::from_fields(get_bits(word_1, 31, 16), get_bits(word_3, 31, 16));
 
-        DsDe = FixedPointFloat(get_bits(word_4, 63, 48), get_bits(word_6, 63, 48), 16, 16, true);
-        DtDe = FixedPointFloat(get_bits(word_4, 47, 32), get_bits(word_6, 47, 32), 16, 16, true);
-        DwDe = FixedPointFloat(get_bits(word_4, 31, 16), get_bits(word_6, 31, 16), 16, 16, true);
+        DsDe = Attribute::from_fields(get_bits(word_4, 63, 48), get_bits(word_6, 63, 48));
+        DtDe = Attribute::from_fields(get_bits(word_4, 47, 32), get_bits(word_6, 47, 32));
+        DwDe = Attribute::from_fields(get_bits(word_4, 31, 16), get_bits(word_6, 31, 16));
 
-        DsDy = FixedPointFloat(get_bits(word_5, 63, 48), get_bits(word_7, 63, 48), 16, 16, true);
-        DtDy = FixedPointFloat(get_bits(word_5, 47, 32), get_bits(word_7, 47, 32), 16, 16, true);
-        DwDy = FixedPointFloat(get_bits(word_5, 31, 16), get_bits(word_7, 31, 16), 16, 16, true);
+        DsDy = Attribute::from_fields(get_bits(word_5, 63, 48), get_bits(word_7, 63, 48));
+        DtDy = Attribute::from_fields(get_bits(word_5, 47, 32), get_bits(word_7, 47, 32));
+        DwDy = Attribute::from_fields(get_bits(word_5, 31, 16), get_bits(word_7, 31, 16));
     }
 
-    FixedPointFloat z, DzDx, DzDe, DzDy;
+    Attribute z{}, DzDx{}, DzDe{}, DzDy{};
 
     if (has_zbuffer) {
         u64 word_0 = rdram_.read_memory<u64>(current_.raw); current_.raw += 8;
         u64 word_1 = rdram_.read_memory<u64>(current_.raw); current_.raw += 8;
 
-        z    = FixedPointFloat(get_bits(word_0, 63, 48), get_bits(word_0, 47, 32), 16, 16, true);
-        DzDx = FixedPointFloat(get_bits(word_0, 31, 16), get_bits(word_0, 15,  0), 16, 16, true);
-        DzDe = FixedPointFloat(get_bits(word_1, 63, 48), get_bits(word_1, 47, 32), 16, 16, true);
-        DzDy = FixedPointFloat(get_bits(word_1, 31, 16), get_bits(word_1, 15,  0), 16, 16, true);
+        z    = Attribute::from_fields(get_bits(word_0, 63, 48), get_bits(word_0, 47, 32));
+        DzDx = Attribute::from_fields(get_bits(word_0, 31, 16), get_bits(word_0, 15,  0));
+        DzDe = Attribute::from_fields(get_bits(word_1, 63, 48), get_bits(word_1, 47, 32));
+        DzDy = Attribute::from_fields(get_bits(word_1, 31, 16), get_bits(word_1, 15,  0));
     }
 
-    s32 y_start = std::max(y_high, scissor_.scissor_rect.top).integer();
-    s32 y_end = std::min(y_low, scissor_.scissor_rect.bottom).integer();
+    s32 y_start = std::max(y_high.integer(), scissor_.scissor_rect.top.integer());
+    s32 y_end = std::min(y_low.integer(), scissor_.scissor_rect.bottom.integer());
+    s32 y_mid_int = y_mid.integer();
+    s32 scissor_left = scissor_.scissor_rect.left.integer();
+    s32 scissor_right = scissor_.scissor_rect.right.integer();
+
+    Attribute eff_DsDx = (cycle_type_ == 2) ? (DsDx >> 2) : DsDx;
+    Attribute eff_DtDx = (cycle_type_ == 2) ? (DtDx >> 2) : DtDx;
+
+    bool do_offset = (dx_high_dy.raw != 0) && (cycle_type_ <= 1);
+    Attribute dsdiff = (do_offset && DsDx.raw == 0) ? DsDe : Attribute{};
+    Attribute dtdiff = (do_offset && DtDx.raw == 0) ? DtDe : Attribute{};
 
     for (s32 y = y_start; y < y_end; y++) {
-        FixedPointFloat x_left;
-        FixedPointFloat x_right;
+        EdgeX x_left;
+        EdgeX x_right;
 
         if (l_major) {
             x_left = x_high;
-            x_right = (y < y_mid.integer()) ? x_mid : x_low;
+            x_right = (y < y_mid_int) ? x_mid : x_low;
         } else {
-            x_left = (y < y_mid.integer()) ? x_mid : x_low;
+            x_left = (y < y_mid_int) ? x_mid : x_low;
             x_right = x_high;
         }
 
-        s32 x_start = std::max(x_left.integer(), scissor_.scissor_rect.left.integer());
-        s32 x_end = std::min(x_right.integer(), scissor_.scissor_rect.right.integer());
+        s32 x_start = std::max(x_left.integer(), scissor_left);
+        s32 x_end = std::min(x_right.integer(), scissor_right);
 
         if (cycle_type_ > 1) x_end++;
 
-        s32 major_x = x_high.integer();
-
-        FixedPointFloat eff_DsDx = (cycle_type_ == 2) ? (DsDx >> 2) : DsDx;
-        FixedPointFloat eff_DtDx = (cycle_type_ == 2) ? (DtDx >> 2) : DtDx;
-
-        bool do_offset = (dx_high_dy.raw() != 0) && (cycle_type_ <= 1);
-        FixedPointFloat dsdiff = (do_offset && DsDx.raw() == 0) ? DsDe : FixedPointFloat();
-        FixedPointFloat dtdiff = (do_offset && DtDx.raw() == 0) ? DtDe : FixedPointFloat();
-
-        for (s32 x = x_start; x < x_end; x++) {
-            s64 dx = x - major_x;
-            s32 tex_s = (s + dsdiff + eff_DsDx * dx).integer() >> 5;
-            s32 tex_t = (t + dtdiff + eff_DtDx * dx).integer() >> 5;
-            s32 r_shade = std::clamp((r + DrDx * dx).integer(), 0, 255);
-            s32 g_shade = std::clamp((g + DgDx * dx).integer(), 0, 255);
-            s32 b_shade = std::clamp((b + DbDx * dx).integer(), 0, 255);
-            s32 a_shade = std::clamp((a + DaDx * dx).integer(), 0, 255);
-            s32 z_pixel = std::clamp((z + DzDx * dx).integer(), 0, 0x7FFF);
+        // Spans entirely behind the depth image are dropped before interpolation
+        s32 dx = x_start - x_high.integer();
+        Attribute z_x = z + DzDx * dx;
+        if (span_behind_depth(y, x_start, x_end, z_x, DzDx)) {
+            pixel_count += x_end - x_start;
+            stats_.pixels_z_rejected += x_end - x_start;
+        } else {
+            // Evaluate the span attributes at x_start once, then step by DxDx per pixel
+            Attribute s_x = s + dsdiff + eff_DsDx * dx;
+            Attribute t_x = t + dtdiff + eff_DtDx * dx;
+            Attribute r_x = r + DrDx * dx;
+            Attribute g_x = g + DgDx * dx;
+            Attribute b_x = b + DbDx * dx;
+            Attribute a_x = a + DaDx * dx;
+
+            // Resolve Z for the whole span up front so occluded pixels skip shading
+            bool depth_tested = (cycle_type_ <= 1) && (z_compare_enable_ || z_update_enable_)
+                && x_start < x_end && depth_test_span(y, x_start, x_end, z_x, DzDx);
+
+            for (s32 x = x_start; x < x_end; x++) {
+                s32 tex_s = s_x.integer() >> 5;
+                s32 tex_t = t_x.integer() >> 5;
+                s32 r_shade = std::clamp(r_x.integer(), 0, 255);
+                s32 g_shade = std::clamp(g_x.integer(), 0, 255);
+                s32 b_shade = std::clamp(b_x.integer(), 0, 255);
+                s32 a_shade = std::clamp(a_x.integer(), 0, 255);
+                s32 z_pixel = std::clamp(z_x.integer(), 0, 0x7FFF);
+
+                s_x += eff_DsDx;
+                t_x += eff_DtDx;
+                r_x += DrDx;
+                g_x += DgDx;
+                b_x += DbDx;
+                a_x += DaDx;
+                z_x += DzDx;
+
+                if (depth_tested && !span_depth_mask_[x - x_start]) {
+                    pixel_count++;
+                    stats_.pixels_z_rejected++;
+                    continue;
+                }
 
-            Color shade(r_shade, g_shade, b_shade, a_shade);
-            u8 pixel_cvg = compute_pixel_cvg(x, x_left, x_right);
-            process_pixel(x, y, tile_index, tex_s, tex_t, shade, z_pixel, pixel_cvg, has_texture, has_shade, pix_log_cnt);
-            pixel_count++;
+                Color shade(r_shade, g_shade, b_shade, a_shade);
+                u8 pixel_cvg = compute_pixel_cvg(x, x_left, x_right);
+                process_pixel(x, y, tile_index, tex_s, tex_t, shade, z_pixel, pixel_cvg, has_texture, has_shade, depth_tested, pix_log_cnt);
+                pixel_count++;
+            }
         }
 
         x_high += dx_high_dy;
-        if (y < y_mid.integer()) {
+        if (y < y_mid_int) {
             x_mid += dx_mid_dy;
         } else {
             x_low += dx_low_dy;
@@ -184,14 +220,14 @@ u32 RDP::triangle(u64 command) {
         z += DzDe;
     }
 
-    return std::max(pixel_count, 8u);
+    return primitive_cost(pixel_count);
 }
 
 void RDP::process_pixel(s32 x, s32 y, u8 tile_index,
                         s32 tex_s, s32 tex_t,
                         const Color& shade, s32 z_depth,
                         u8 pixel_cvg,
-                        bool has_texture, bool has_shade,
+                        bool has_texture, bool has_shade, bool depth_tested,
                         int& pix_log_cnt) {
     u32 fb_bpp = bytes_per_pixel(color_image_.size);
     u32 fb_addr = color_image_.addr + (y * color_image_.width + x) * fb_bpp;
@@ -212,23 +248,30 @@ void RDP::process_pixel(s32 x, s32 y, u8 tile_index,
         case 0: { // 1-cycle
             Color texel0, texel1;
 
-            if (z_compare_enable_) {
-                u16 old_z = rdram_.read_memory<u16>(z_addr);
-                if (z_depth >= old_z) return;
-            }
-            if (z_update_enable_) {
-                rdram_.write_memory<u16>(z_addr, z_depth);
+            if (!depth_tested) {
+                if (z_compare_enable_) {
+                    u16 old_z = rdram_.read_memory<u16>(z_addr);
+                    record_traffic(memory::AccessProfiler::Dma::DPDepth, z_addr, 2, false);
+                    if (z_depth >= old_z) {
+                        stats_.pixels_z_rejected++;
+                        return;
+                    }
+                }
+                if (z_update_enable_) {
+                    depth_cache_.store(y * color_image_.width + x, z_depth);
+                }
             }
 
             if (has_texture) {
                 s32 s_offset = (tile.size == Size::SIZE_4B) ? (tex_s >> 1) : static_cast<s32>(tex_s * bytes_per_pixel(tile.size));
-                u32 tmem_addr = (tile.address + tex_t * (s32)tile.line_bytes + s_offset) & 0xFFF;
+                u32 tmem_addr = ((tile.address + tex_t * (s32)tile.line_bytes + s_offset) ^ ((tex_t & 1) << 2)) & 0xFFF;
                 texel0 = fetch_pixel_tmem(tmem_addr, tile.size, tile.format, tex_s & 1, tile.palette);
 
                 const auto& next_tile = tiles_[(tile_index + 1) & 7];
                 s32 s_offset1 = (next_tile.size == Size::SIZE_4B) ? (tex_s >> 1) : static_cast<s32>(tex_s * bytes_per_pixel(next_tile.size));
-                u32 tmem_addr1 = (next_tile.address + tex_t * (s32)next_tile.line_bytes + s_offset1) & 0xFFF;
+                u32 tmem_addr1 = ((next_tile.address + tex_t * (s32)next_tile.line_bytes + s_offset1) ^ ((tex_t & 1) << 2)) & 0xFFF;
                 texel1 = fetch_pixel_tmem(tmem_addr1, next_tile.size, next_tile.format, tex_s & 1, next_tile.palette);
+                stats_.texels_fetched += 2;
 
                 if (is_pixel_transparent(texel0)) return;
             }
@@ -244,7 +287,7 @@ void RDP::process_pixel(s32 x, s32 y, u8 tile_index,
             }
 
             Color fb_before = read_pixel_framebuffer(fb_addr);
-            u8 blend_cvg = cvg_buffer_[y * color_image_.width + x];
+            u8 blend_cvg = coverage_.get(y * color_image_.width + x);
             u8 cvg_5bit = (blend_cvg << 2) | (blend_cvg >> 1);
             result = blender_.blend(result, fb_before, shade, cvg_5bit, 0);
             apply_rgb_dither(x, y, result);
@@ -261,23 +304,30 @@ void RDP::process_pixel(s32 x, s32 y, u8 tile_index,
         case 1: { // 2-cycle
             Color texel0, texel1;
 
-            if (z_compare_enable_) {
-                u16 old_z = rdram_.read_memory<u16>(z_addr);
-                if (z_depth >= old_z) return;
-            }
-            if (z_update_enable_) {
-                rdram_.write_memory<u16>(z_addr, z_depth);
+            if (!depth_tested) {
+                if (z_compare_enable_) {
+                    u16 old_z = rdram_.read_memory<u16>(z_addr);
+                    record_traffic(memory::AccessProfiler::Dma::DPDepth, z_addr, 2, false);
+                    if (z_depth >= old_z) {
+                        stats_.pixels_z_rejected++;
+                        return;
+                    }
+                }
+                if (z_update_enable_) {
+                    depth_cache_.store(y * color_image_.width + x, z_depth);
+                }
             }
 
             if (has_texture) {
                 s32 s_offset = (tile.size == Size::SIZE_4B) ? (tex_s >> 1) : static_cast<s32>(tex_s * bytes_per_pixel(tile.size));
-                u32 tmem_addr = (tile.address + tex_t * (s32)tile.line_bytes + s_offset) & 0xFFF;
+                u32 tmem_addr = ((tile.address + tex_t * (s32)tile.line_bytes + s_offset) ^ ((tex_t & 1) << 2)) & 0xFFF;
                 texel0 = fetch_pixel_tmem(tmem_addr, tile.size, tile.format, tex_s & 1, tile.palette);
 
                 const auto& next_tile = tiles_[(tile_index + 1) & 7];
                 s32 s_offset1 = (next_tile.size == Size::SIZE_4B) ? (tex_s >> 1) : static_cast<s32>(tex_s * bytes_per_pixel(next_tile.size));
-                u32 tmem_addr1 = (next_tile.address + tex_t * (s32)next_tile.line_bytes + s_offset1) & 0xFFF;
+                u32 tmem_addr1 = ((next_tile.address + tex_t * (s32)next_tile.line_bytes + s_offset1) ^ ((tex_t & 1) << 2)) & 0xFFF;
                 texel1 = fetch_pixel_tmem(tmem_addr1, next_tile.size, next_tile.format, tex_s & 1, next_tile.palette);
+                stats_.texels_fetched += 2;
 
                 if (is_pixel_transparent(texel0)) return;
             }
@@ -295,7 +345,7 @@ void RDP::process_pixel(s32 x, s32 y, u8 tile_index,
             }
 
             Color fb_before = read_pixel_framebuffer(fb_addr);
-            u8 blend_cvg = cvg_buffer_[y * color_image_.width + x];
+            u8 blend_cvg = coverage_.get(y * color_image_.width + x);
             u8 cvg_5bit = (blend_cvg << 2) | (blend_cvg >> 1);
             Color blended0 = blender_.blend(result, fb_before, shade, cvg_5bit, 0);
             result = blender_.blend(blended0, fb_before, shade, cvg_5bit, 1);
@@ -314,8 +364,9 @@ void RDP::process_pixel(s32 x, s32 y, u8 tile_index,
         case 2: { // copy
             if (!has_texture) return;
             float tex_bpp = bytes_per_pixel(tile.size);
-            u32 tmem_addr = tile.address + tex_t * tile.line_bytes + static_cast<u32>(tex_s * tex_bpp);
+            u32 tmem_addr = (tile.address + tex_t * tile.line_bytes + static_cast<u32>(tex_s * tex_bpp)) ^ ((tex_t & 1) << 2);
             Color texel = fetch_pixel_tmem(tmem_addr, tile.size, tile.format, tex_s & 1, tile.palette);
+            stats_.texels_fetched++;
             if (is_pixel_transparent(texel)) return;
             write_pixel_framebuffer(fb_addr, texel);
             break;
@@ -325,10 +376,12 @@ void RDP::process_pixel(s32 x, s32 y, u8 tile_index,
                 case Size::SIZE_16B: {
                     u16 color = (x & 1) ? (fill_color_ & 0xFFFF) : (fill_color_ >> 16);
                     rdram_.write_memory<u16>(fb_addr, color);
+                    record_traffic(memory::AccessProfiler::Dma::DPColor, fb_addr, 2, true);
                     break;
                 }
                 case Size::SIZE_32B:
                     rdram_.write_memory<u32>(fb_addr, fill_color_);
+                    record_traffic(memory::AccessProfiler::Dma::DPColor, fb_addr, 4, true);
                     break;
                 default:
                     break;
@@ -340,9 +393,68 @@ void RDP::process_pixel(s32 x, s32 y, u8 tile_index,
     }
 }
 
+// Coarse rejection of a 1/2-cycle span against the depth cache. Z is linear
+// along the span, so its nearest value is at one of the two ends; spans whose
+// Z wraps are never rejected.
+bool RDP::span_behind_depth(s32 y, s32 x_start, s32 x_end, Attribute z, Attribute dzdx) {
+    if (cycle_type_ > 1 || !z_compare_enable_ || x_start >= x_end) return false;
+
+    u16 nearest_z = z_prim_depth_;
+    if (!z_source_select_) {
+        s64 first = z.raw;
+        s64 last = first + static_cast<s64>(dzdx.raw) * (x_end - x_start - 1);
+        if (last < INT32_MIN || last > INT32_MAX) return false;
+        nearest_z = std::clamp<s64>(std::min(first, last) >> 16, 0, 0x7FFF);
+    }
+    return depth_cache_.span_occluded(y, x_start, x_end, nearest_z);
+}
+
+// Z pre-pass for one 1/2-cycle triangle span. Depth values are compared and
+// written back eight pixels per step (old Z is kept in failing lanes), and the
+// per-pixel result is left in span_depth_mask_. Returns false when the depth
+// row is not fully inside RDRAM or overlaps the color row; process_pixel then
+// handles Z per pixel as before.
+bool RDP::depth_test_span(s32 y, s32 x_start, s32 x_end, Attribute z, Attribute dzdx) {
+    constexpr u32 LANES = 8;
+
+    u32 count = x_end - x_start;
+    u32 z_row = z_buffer_addr_ + (y * color_image_.width + x_start) * 2;
+    if (!rdram_.contains(z_row, count * 2)) return false;
+
+    u32 fb_bpp = std::max<u32>(bytes_per_pixel(color_image_.size), 1);
+    u32 fb_row = color_image_.addr + (y * color_image_.width + x_start) * fb_bpp;
+    if (z_row < fb_row + count * fb_bpp && fb_row < z_row + count * 2) return false;
+
+    span_depth_mask_.resize(count);
+    for (u32 i = 0; i < count; i += LANES) {
+        u32 lanes = std::min(LANES, count - i);
+        u8 z_bytes[LANES * 2] = {};
+        rdram_.read_block(z_row + i * 2, z_bytes, lanes * 2);
+        record_traffic(memory::AccessProfiler::Dma::DPDepth, z_row + i * 2, lanes * 2, false);
+
+        u8 pass[LANES];
+        for (u32 l = 0; l < LANES; l++) {
+            u16 old_z = (z_bytes[l * 2] << 8) | z_bytes[l * 2 + 1];
+            s32 z_raw = static_cast<s32>(static_cast<u32>(z.raw) + (i + l) * static_cast<u32>(dzdx.raw));
+            u16 new_z = z_source_select_ ? z_prim_depth_ : std::clamp(z_raw >> 16, 0, 0x7FFF);
+            pass[l] = !z_compare_enable_ || new_z < old_z;
+            u16 out_z = pass[l] ? new_z : old_z;
+            z_bytes[l * 2] = out_z >> 8;
+            z_bytes[l * 2 + 1] = out_z & 0xFF;
+        }
+
+        std::memcpy(&span_depth_mask_[i], pass, lanes);
+        if (z_update_enable_) {
+            depth_cache_.store(y * color_image_.width + x_start + i, z_bytes, lanes);
+        }
+    }
+    return true;
+}
+
 u32 RDP::texture_rectangle(u64 command) {
     Rectangle texture_rect(command);
     u8 tile_index = get_bits(command, 26, 24);
+    count_primitive(stats_.rectangles);
 
     scissor_.clip(texture_rect);
     if (cycle_type_ > 1) {
@@ -352,79 +464,91 @@ u32 RDP::texture_rectangle(u64 command) {
 
     command = rdram_.read_memory<u64>(current_.raw);
     current_.raw += 8;
-    FixedPointFloat s(get_bits(command, 63, 53), get_bits(command, 52, 48), 11, 5, true);
-    FixedPointFloat t(get_bits(command, 47, 37), get_bits(command, 36, 32), 11, 5, true);
-    FixedPointFloat dsdx(get_bits(command, 31, 26), get_bits(command, 25, 16), 6, 10, true);
-    FixedPointFloat dtdy(get_bits(command, 15, 10), get_bits(command, 9, 0), 6, 10, true);
+    auto s = TexCoord::from_fields(get_bits(command, 63, 53), get_bits(command, 52, 48));
+    auto t = TexCoord::from_fields(get_bits(command, 47, 37), get_bits(command, 36, 32));
+    auto dsdx = TexSlope::from_fields(get_bits(command, 31, 26), get_bits(command, 25, 16));
+    auto dtdy = TexSlope::from_fields(get_bits(command, 15, 10), get_bits(command, 9, 0));
 
     const auto& tile = tiles_[tile_index];
-    FixedPointFloat s_inc = (cycle_type_ == 2) ? (dsdx >> 2) : dsdx;
-    FixedPointFloat t_acc = t;
+    TexSlope s_inc = (cycle_type_ == 2) ? (dsdx >> 2) : dsdx;
+    TexCoord t_acc = t;
     u32 pixel_count = 0;
     [[maybe_unused]] int pix_log_cnt = 0;
 
     RDP_LOG_PRIM("texrect: rect=(%d,%d)-(%d,%d) tile=%u S=%d T=%d DsDx_raw=%d DtDy_raw=%d mask_s=%u mask_t=%u",
         texture_rect.left.integer(), texture_rect.top.integer(),
         texture_rect.right.integer(), texture_rect.bottom.integer(),
-        tile_index, s.integer(), t.integer(), dsdx.raw(), dtdy.raw(),
+        tile_index, s.integer(), t.integer(), dsdx.raw, dtdy.raw,
         tile.mask_s, tile.mask_t);
 
-    for (u16 y = texture_rect.top.integer(); y < texture_rect.bottom.integer(); y++) {
-        FixedPointFloat s_acc = s;
+    if (cycle_type_ == 2 && copy_texture_rectangle(texture_rect, tile_index, s, t, s_inc, dtdy, pixel_count)) {
+        return primitive_cost(pixel_count);
+    }
+
+    s32 left = texture_rect.left.integer();
+    s32 right = texture_rect.right.integer();
+    s32 bottom = texture_rect.bottom.integer();
+    for (s32 y = texture_rect.top.integer(); y < bottom; y++) {
+        TexCoord s_acc = s;
         s32 tex_t = t_acc.integer();
-        for (u16 x = texture_rect.left.integer(); x < texture_rect.right.integer(); x++) {
+        for (s32 x = left; x < right; x++) {
             s32 tex_s = s_acc.integer();
             s_acc += s_inc;
 
-            process_pixel(x, y, tile_index, tex_s, tex_t, Color(), 0, 0x07, true, false, pix_log_cnt);
+            process_pixel(x, y, tile_index, tex_s, tex_t, Color(), 0, 0x07, true, false, false, pix_log_cnt);
             pixel_count++;
         }
         t_acc += dtdy;
     }
-    return std::max(pixel_count, 8u);
+    return primitive_cost(pixel_count);
 }
 
 u32 RDP::texture_rectangle_flip(u64 command) {
     
     Rectangle flip_rect(command);
     u8 tile_index = get_bits(command, 26, 24);
+    count_primitive(stats_.rectangles);
 
     scissor_.clip(flip_rect);
 
     command = rdram_.read_memory<u64>(current_.raw);
     current_.raw += 8;
-    FixedPointFloat s(get_bits(command, 63, 53), get_bits(command, 52, 48), 11, 5, true);
-    FixedPointFloat t(get_bits(command, 47, 37), get_bits(command, 36, 32), 11, 5, true);
-    FixedPointFloat dsdx(get_bits(command, 31, 26), get_bits(command, 25, 16), 6, 10, true);
-    FixedPointFloat dtdy(get_bits(command, 15, 10), get_bits(command, 9, 0), 6, 10, true);
+    auto s = TexCoord::from_fields(get_bits(command, 63, 53), get_bits(command, 52, 48));
+    auto t = TexCoord::from_fields(get_bits(command, 47, 37), get_bits(command, 36, 32));
+    auto dsdx = TexSlope::from_fields(get_bits(command, 31, 26), get_bits(command, 25, 16));
+    auto dtdy = TexSlope::from_fields(get_bits(command, 15, 10), get_bits(command, 9, 0));
 
-    FixedPointFloat s_inc = (cycle_type_ == 2) ? (dsdx >> 2) : dsdx;
-    FixedPointFloat s_acc = s;
+    TexSlope s_inc = (cycle_type_ == 2) ? (dsdx >> 2) : dsdx;
+    TexCoord s_acc = s;
     u32 pixel_count = 0;
     [[maybe_unused]] int pix_log_cnt = 0;
 
     RDP_LOG_PRIM("texrect_flip: rect=(%d,%d)-(%d,%d) tile=%u S=%d T=%d DsDx_raw=%d DtDy_raw=%d",
         flip_rect.left.integer(), flip_rect.top.integer(),
         flip_rect.right.integer(), flip_rect.bottom.integer(),
-        tile_index, s.integer(), t.integer(), dsdx.raw(), dtdy.raw());
+        tile_index, s.integer(), t.integer(), dsdx.raw, dtdy.raw);
 
-    for (u16 y = flip_rect.top.integer(); y < flip_rect.bottom.integer(); y++) {
-        FixedPointFloat t_acc = t;
+    s32 left = flip_rect.left.integer();
+    s32 right = flip_rect.right.integer();
+    s32 bottom = flip_rect.bottom.integer();
+    for (s32 y = flip_rect.top.integer(); y < bottom; y++) {
+        TexCoord t_acc = t;
         s32 tex_s = s_acc.integer();
-        for (u16 x = flip_rect.left.integer(); x < flip_rect.right.integer(); x++) {
+        for (s32 x = left; x < right; x++) {
             s32 tex_t = t_acc.integer();
             t_acc += dtdy;
 
-            process_pixel(x, y, tile_index, tex_s, tex_t, Color(), 0, 0x07, true, false, pix_log_cnt);
+            process_pixel(x, y, tile_index, tex_s, tex_t, Color(), 0, 0x07, true, false, false, pix_log_cnt);
             pixel_count++;
         }
         s_acc += s_inc;
     }
-    return std::max(pixel_count, 8u);
+    return primitive_cost(pixel_count);
 }
 
 u32 RDP::fill_rectangle(u64 command) {
     Rectangle fill_rect(command);
+    count_primitive(stats_.rectangles);
 
     scissor_.clip(fill_rect);
 
@@ -445,11 +569,11 @@ u32 RDP::fill_rectangle(u64 command) {
             [[maybe_unused]] int pix_log_cnt = 0;
             for (u16 y = fill_rect.top.integer(); y <= fill_rect.bottom.integer(); y++) {
                 for (u16 x = fill_rect.left.integer(); x <= fill_rect.right.integer(); x++) {
-                    process_pixel(x, y, 0, 0, 0, Color(), 0, 0x07, false, false, pix_log_cnt);
+                    process_pixel(x, y, 0, 0, 0, Color(), 0, 0x07, false, false, false, pix_log_cnt);
                     pixel_count++;
                 }
             }
-            return std::max(pixel_count, 8u);
+            return primitive_cost(pixel_count);
         }
         case 2:
             return copy_rectangle(fill_rect);
@@ -468,24 +592,147 @@ u32 RDP::copy_rectangle(const Rectangle& copy_rect) {
         for (u16 x = copy_rect.left.integer(); x <= copy_rect.right.integer(); x++) {
             s32 tex_s = x - copy_rect.left.integer();
             s32 tex_t = y - copy_rect.top.integer();
-            process_pixel(x, y, tile_index_, tex_s, tex_t, Color(), 0, 0x07, true, false, pix_log_cnt);
+            process_pixel(x, y, tile_index_, tex_s, tex_t, Color(), 0, 0x07, true, false, false, pix_log_cnt);
             pixel_count++;
         }
     }
-    return std::max(pixel_count, 8u);
+    return primitive_cost(pixel_count);
 }
 
 u32 RDP::fill_rectangle(const Rectangle& fill_rect) {
-    u32 pixel_count = 0;
-    [[maybe_unused]] int pix_log_cnt = 0;
+    s32 left = fill_rect.left.integer();
+    s32 top = fill_rect.top.integer();
+    s32 right = fill_rect.right.integer();
+    s32 bottom = fill_rect.bottom.integer();
+    if (left > right || top > bottom) return 8;
+
+    u32 span_pixels = right - left + 1;
+    u32 pixel_count = span_pixels * (bottom - top + 1);
+
+    // Fill mode only writes 16b and 32b color images
+    if (color_image_.size != Size::SIZE_16B && color_image_.size != Size::SIZE_32B) {
+        return primitive_cost(pixel_count);
+    }
 
-    for (u16 y = fill_rect.top.integer(); y <= fill_rect.bottom.integer(); y++) {
-        for (u16 x = fill_rect.left.integer(); x <= fill_rect.right.integer(); x++) {
-            process_pixel(x, y, 0, 0, 0, Color(), 0, 0x07, false, false, pix_log_cnt);
-            pixel_count++;
+    u32 fb_bpp = bytes_per_pixel(color_image_.size);
+    u32 span_bytes = span_pixels * fb_bpp;
+    u32 first_addr = color_image_.addr + (top * color_image_.width + left) * fb_bpp;
+    u32 last_addr = color_image_.addr + (bottom * color_image_.width + right + 1) * fb_bpp;
+
+    if (!rdram_.contains(first_addr, last_addr - first_addr)) {
+        [[maybe_unused]] int pix_log_cnt = 0;
+        for (u16 y = top; y <= bottom; y++) {
+            for (u16 x = left; x <= right; x++) {
+                process_pixel(x, y, 0, 0, 0, Color(), 0, 0x07, false, false, false, pix_log_cnt);
+            }
         }
+        return primitive_cost(pixel_count);
+    }
+
+    // Every row gets the same bytes: the fill color repeated, with 16b spans
+    // starting on an odd x beginning at its low half. Build the span once with
+    // 64-bit pattern stores and copy it into each row.
+    u32 phase = (fb_bpp == 2 && (left & 1)) ? 2 : 0;
+    u8 pattern_bytes[8];
+    for (u32 i = 0; i < 8; i++) {
+        pattern_bytes[i] = static_cast<u8>(fill_color_ >> (24 - 8 * ((i + phase) & 3)));
+    }
+    u64 pattern;
+    std::memcpy(&pattern, pattern_bytes, sizeof(pattern));
+
+    span_buffer_.resize((span_bytes + 7) & ~7u);
+    for (size_t i = 0; i < span_buffer_.size(); i += 8) {
+        std::memcpy(&span_buffer_[i], &pattern, sizeof(pattern));
+    }
+
+    for (s32 y = top; y <= bottom; y++) {
+        u32 row_addr = color_image_.addr + (y * color_image_.width + left) * fb_bpp;
+        rdram_.write_block(row_addr, span_buffer_.data(), span_bytes);
     }
-    return std::max(pixel_count, 8u);
+    record_traffic(memory::AccessProfiler::Dma::DPColor, first_addr, span_bytes, true, bottom - top + 1,
+                   color_image_.width * fb_bpp - span_bytes);
+    return primitive_cost(pixel_count);
+}
+
+// Copy-mode Texture_Rectangle as row blits. T (and its wrap/clamp) is constant
+// per row, so each row is fetched into span_buffer_ with the scaled S stepping
+// and written back in one block. Returns false when the rows are not fully
+// inside RDRAM or the color image is not 16b/32b; the caller then falls back
+// to the per-pixel path.
+bool RDP::copy_texture_rectangle(const Rectangle& rect, u8 tile_index,
+                                 TexCoord s, TexCoord t,
+                                 TexSlope s_inc, TexSlope dtdy,
+                                 u32& pixel_count) {
+    if (color_image_.size != Size::SIZE_16B && color_image_.size != Size::SIZE_32B) return false;
+
+    s32 left = rect.left.integer();
+    s32 top = rect.top.integer();
+    s32 right = rect.right.integer();
+    s32 bottom = rect.bottom.integer();
+    if (left >= right || top >= bottom) return false;
+
+    u32 fb_bpp = bytes_per_pixel(color_image_.size);
+    u32 span_pixels = right - left;
+    u32 span_bytes = span_pixels * fb_bpp;
+    u32 first_addr = color_image_.addr + (top * color_image_.width + left) * fb_bpp;
+    u32 last_addr = color_image_.addr + ((bottom - 1) * color_image_.width + right) * fb_bpp;
+    if (!rdram_.contains(first_addr, last_addr - first_addr)) return false;
+
+    const auto& tile = tiles_[tile_index];
+    float tex_bpp = bytes_per_pixel(tile.size);
+    span_buffer_.resize(span_bytes);
+
+    TexCoord t_acc = t;
+    for (s32 y = top; y < bottom; y++) {
+        u32 row_addr = color_image_.addr + (y * color_image_.width + left) * fb_bpp;
+
+        // Transparent texels leave the framebuffer untouched
+        if (alpha_compare_enable_) {
+            rdram_.read_block(row_addr, span_buffer_.data(), span_bytes);
+        }
+
+        s32 tex_t = t_acc.integer();
+        process_tmem_coordinates(tex_t, tile.shift_t, tile.mask_t, tile.mirror_t, tile.clamp_t, tile.upper_left_t, tile.lower_right_t);
+        u32 row_tmem_addr = tile.address + tex_t * tile.line_bytes;
+        // Odd TMEM rows hold their 32-bit words swapped
+        u32 row_swap = (tex_t & 1) << 2;
+
+        TexCoord s_acc = s;
+        u8* out = span_buffer_.data();
+        for (u32 i = 0; i < span_pixels; i++, out += fb_bpp) {
+            s32 tex_s = s_acc.integer();
+            s_acc += s_inc;
+            process_tmem_coordinates(tex_s, tile.shift_s, tile.mask_s, tile.mirror_s, tile.clamp_s, tile.upper_left_s, tile.lower_right_s);
+
+            u32 tmem_addr = (row_tmem_addr + static_cast<u32>(tex_s * tex_bpp)) ^ row_swap;
+            Color texel = fetch_pixel_tmem(tmem_addr, tile.size, tile.format, tex_s & 1, tile.palette);
+            if (is_pixel_transparent(texel)) continue;
+
+            if (fb_bpp == 2) {
+                u16 value = texel.encode_16b() | 1;
+                out[0] = value >> 8;
+                out[1] = value & 0xFF;
+            } else {
+                u32 value = texel.encode_32b() | 0xFF;
+                out[0] = value >> 24;
+                out[1] = (value >> 16) & 0xFF;
+                out[2] = (value >> 8) & 0xFF;
+                out[3] = value & 0xFF;
+            }
+        }
+        rdram_.write_block(row_addr, span_buffer_.data(), span_bytes);
+        t_acc += dtdy;
+    }
+
+    u32 row_skip = color_image_.width * fb_bpp - span_bytes;
+    if (alpha_compare_enable_) {
+        record_traffic(memory::AccessProfiler::Dma::DPColor, first_addr, span_bytes, false, bottom - top, row_skip);
+    }
+    record_traffic(memory::AccessProfiler::Dma::DPColor, first_addr, span_bytes, true, bottom - top, row_skip);
+
+    pixel_count = span_pixels * (bottom - top);
+    stats_.texels_fetched += pixel_count;
+    return true;
 }
 
 void RDP::apply_alpha_dither(s32 x, s32 y, Color& color) {
@@ -538,7 +785,7 @@ void RDP::apply_rgb_dither(s32 x, s32 y, Color& color) {
     }
 }
 
-u8 RDP::compute_pixel_cvg(s32 x, FixedPointFloat x_left, FixedPointFloat x_right) const {
+u8 RDP::compute_pixel_cvg(s32 x, EdgeX x_left, EdgeX x_right) const {
     // TODO: Implement sub-pixel coverage calculation
     if (x == x_left.integer()) {
         u8 frac = x_left.frac() >> 13;
@@ -552,7 +799,7 @@ u8 RDP::compute_pixel_cvg(s32 x, FixedPointFloat x_left, FixedPointFloat x_right
 
 bool RDP::apply_alpha_coverage(u8 pixel_cvg, u32 cvg_index, Color& color) {
     u8 new_cvg = pixel_cvg;
-    u8 old_cvg = image_read_enable_ ? cvg_buffer_[cvg_index] : 0;
+    u8 old_cvg = image_read_enable_ ? coverage_.get(cvg_index) : 0;
 
     if (cvg_x_alpha_) {
         new_cvg = (pixel_cvg * color.alpha + 128) / 255;
@@ -570,7 +817,7 @@ bool RDP::apply_alpha_coverage(u8 pixel_cvg, u32 cvg_index, Color& color) {
         case 3: final_cvg = old_cvg; break;
         default: final_cvg = 7; break;
     }
-    cvg_buffer_[cvg_index] = final_cvg;
+    coverage_.set(cvg_index, final_cvg);
 
     return color_on_cvg_ && !overflow;
 }
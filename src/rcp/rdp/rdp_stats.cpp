@@ -0,0 +1,37 @@
+#include "rdp_stats.hpp"
+
+namespace n64::rdp {
+
+StatsWriter::StatsWriter(const std::string& path) {
+    file_ = std::fopen(path.c_str(), "w");
+    if (!file_) {
+        fprintf(stderr, "[RDP] Failed to open stats file %s\n", path.c_str());
+        return;
+    }
+    fprintf(file_, "frame,triangles,rectangles,pixels_shaded,pixels_z_rejected,texels_fetched,"
+                   "tmem_loads,tmem_load_bytes,combiner_switches,prims_1cycle,prims_2cycle,prims_copy,prims_fill\n");
+    fprintf(stderr, "[RDP] Writing frame statistics to %s\n", path.c_str());
+}
+
+StatsWriter::~StatsWriter() {
+    if (file_) {
+        std::fclose(file_);
+    }
+}
+
+void StatsWriter::write(const FrameStats& stats) {
+    if (!file_) return;
+    fprintf(file_, "%llu,%u,%u,%llu,%llu,%llu,%u,%llu,%u,%u,%u,%u,%u\n",
+        static_cast<unsigned long long>(stats.frame),
+        stats.triangles, stats.rectangles,
+        static_cast<unsigned long long>(stats.pixels_shaded()),
+        static_cast<unsigned long long>(stats.pixels_z_rejected),
+        static_cast<unsigned long long>(stats.texels_fetched),
+        stats.tmem_loads,
+        static_cast<unsigned long long>(stats.tmem_load_bytes),
+        stats.combiner_switches,
+        stats.cycle_type_primitives[0], stats.cycle_type_primitives[1],
+        stats.cycle_type_primitives[2], stats.cycle_type_primitives[3]);
+}
+
+} // namespace n64::rdp
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "../../utils/types.hpp"
+#include <array>
+#include <cstdio>
+#include <string>
+
+namespace n64::rdp {
+
+// Work done by the RDP during one frame. A frame ends at each Sync_Full,
+// which games issue once per displayed frame after the last primitive.
+struct FrameStats {
+    u64 frame = 0;
+    u32 triangles = 0;
+    u32 rectangles = 0;
+    u64 pixels_covered = 0;      // pixels inside primitives after scissoring
+    u64 pixels_z_rejected = 0;   // covered pixels dropped by the depth test
+    u64 texels_fetched = 0;
+    u32 tmem_loads = 0;          // Load_Block, Load_Tile and Load_TLUT
+    u64 tmem_load_bytes = 0;
+    u32 combiner_switches = 0;   // Set_Combine with a different mode
+    std::array<u32, 4> cycle_type_primitives{};  // 1-cycle, 2-cycle, copy, fill
+
+    [[nodiscard]] u64 pixels_shaded() const { return pixels_covered - pixels_z_rejected; }
+};
+
+// Appends one CSV row per frame
+class StatsWriter {
+public:
+    explicit StatsWriter(const std::string& path);
+    ~StatsWriter();
+
+    StatsWriter(const StatsWriter&) = delete;
+    StatsWriter& operator=(const StatsWriter&) = delete;
+
+    [[nodiscard]] bool is_open() const { return file_ != nullptr; }
+
+    void write(const FrameStats& stats);
+
+private:
+    std::FILE* file_ = nullptr;
+};
+
+} // namespace n64::rdp
@@ -3,6 +3,12 @@
 #include "../../memory/rdram.hpp"
 
 #include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
 namespace n64::rdp {
 
 float RDP::bytes_per_pixel(Size size) const {
@@ -93,10 +99,12 @@ void RDP::write_pixel_framebuffer(u32 addr, const Color& color) {
         }
         case Size::SIZE_16B: {
             rdram_.write_memory<u16>(addr, color.encode_16b() | 1);
+            record_traffic(memory::AccessProfiler::Dma::DPColor, addr, 2, true);
             break;
         }
         case Size::SIZE_32B: {
             rdram_.write_memory<u32>(addr, color.encode_32b() | 0xFF);
+            record_traffic(memory::AccessProfiler::Dma::DPColor, addr, 4, true);
             break;
         }
     default:
@@ -109,11 +117,13 @@ Color RDP::read_pixel_framebuffer(u32 addr) const {
     switch (color_image_.size) {
         case Size::SIZE_16B: {
             u16 raw = rdram_.read_memory<u16>(addr);
+            record_traffic(memory::AccessProfiler::Dma::DPColor, addr, 2, false);
             color.set_color_16b(raw, Format::FORMAT_RGB);
             break;
         }
         case Size::SIZE_32B: {
             u32 raw = rdram_.read_memory<u32>(addr);
+            record_traffic(memory::AccessProfiler::Dma::DPColor, addr, 4, false);
             color.set_color_32b(raw, Format::FORMAT_RGB);
             break;
         }
@@ -152,25 +162,97 @@ void RDP::process_tmem_coordinates(s32& coord, u8 shift, u8 mask, bool mirror, b
     }
 }
 
+void RDP::load_tmem_row(u32 rdram_addr, u32 tmem_addr, u32 length, bool odd_row) {
+    record_traffic(memory::AccessProfiler::Dma::DPTexture, rdram_addr, length, false);
+    span_buffer_.resize(length);
+    if (rdram_.contains(rdram_addr, length)) {
+        rdram_.read_block(rdram_addr, span_buffer_.data(), length);
+    } else {
+        for (u32 i = 0; i < length; i++) {
+            span_buffer_[i] = rdram_.read_memory<u8>(rdram_addr + i);
+        }
+    }
+
+    tmem_addr &= 0xFFF;
+    if (!odd_row) {
+        for (u32 done = 0; done < length; ) {
+            u32 chunk = std::min(length - done, 4096 - tmem_addr);
+            std::memcpy(&tmem_[tmem_addr], &span_buffer_[done], chunk);
+            done += chunk;
+            tmem_addr = 0;
+        }
+        return;
+    }
+
+    // Odd rows are stored with the 32-bit halves of every 64-bit word swapped.
+    // Word-aligned rows swap two words per SSE2 shuffle, then one per 32-bit
+    // rotate around the wrap at the end of TMEM.
+    u32 i = 0;
+    if ((tmem_addr & 7) == 0) {
+#if defined(__SSE2__)
+        for (; i + 16 <= length && ((tmem_addr + i) & 0xFFF) <= 4096 - 16; i += 16) {
+            __m128i words = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&span_buffer_[i]));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(&tmem_[(tmem_addr + i) & 0xFFF]),
+                             _mm_shuffle_epi32(words, _MM_SHUFFLE(2, 3, 0, 1)));
+        }
+#endif
+        for (; i + 8 <= length; i += 8) {
+            u64 word;
+            std::memcpy(&word, &span_buffer_[i], 8);
+            word = (word >> 32) | (word << 32);
+            std::memcpy(&tmem_[(tmem_addr + i) & 0xFFF], &word, 8);
+        }
+    }
+    for (; i < length; i++) {
+        tmem_[((tmem_addr + i) ^ 4) & 0xFFF] = span_buffer_[i];
+    }
+}
+
 u32 RDP::load_tlut(u64 command) {
     u16 sl = get_bits(command, 55, 44) >> 2;
     u16 sh = get_bits(command, 23, 12) >> 2;
+    u32 entries = (sh >= sl) ? sh - sl + 1 : 0;
+
+    u32 rdram_addr = texture_image_.addr + sl * 2;
+    record_traffic(memory::AccessProfiler::Dma::DPTexture, rdram_addr, entries * 2, false);
+    span_buffer_.resize(entries * 2);
+    if (rdram_.contains(rdram_addr, entries * 2)) {
+        rdram_.read_block(rdram_addr, span_buffer_.data(), entries * 2);
+    } else {
+        for (u32 i = 0; i < entries * 2; i++) {
+            span_buffer_[i] = rdram_.read_memory<u8>(rdram_addr + i);
+        }
+    }
 
-    for (u16 index = sl; index <= sh; index++) {
-        u32 rdram_addr = texture_image_.addr + index * 2;
-        u32 tmem_addr = TLUT_BASE_ADDRESS + index * 8;
-        u16 color = rdram_.read_memory<u16>(rdram_addr);
-        tmem_[(tmem_addr + 0) % 4096] = (color >> 8) & 0xFF;
-        tmem_[(tmem_addr + 1) % 4096] = color & 0xFF;
+    // Each 16-bit entry is quadruplicated across the four banks of the high
+    // half: SSE2 widens four entries into four quadruplicated words at a time,
+    // the rest are broadcast to a 64-bit word by multiplication.
+    u32 i = 0;
+#if defined(__SSE2__)
+    for (; i + 4 <= entries && ((TLUT_BASE_ADDRESS + (sl + i) * 8) & 0xFFF) <= 4096 - 32; i += 4) {
+        __m128i pairs = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&span_buffer_[i * 2]));
+        pairs = _mm_unpacklo_epi16(pairs, pairs);
+        u8* dst = &tmem_[(TLUT_BASE_ADDRESS + (sl + i) * 8) & 0xFFF];
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_unpacklo_epi32(pairs, pairs));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 16), _mm_unpackhi_epi32(pairs, pairs));
+    }
+#endif
+    for (; i < entries; i++) {
+        u16 entry;
+        std::memcpy(&entry, &span_buffer_[i * 2], 2);
+        u64 word = entry * 0x0001000100010001ULL;
+        std::memcpy(&tmem_[(TLUT_BASE_ADDRESS + (sl + i) * 8) & 0xFFF], &word, 8);
     }
+    stats_.tmem_loads++;
+    stats_.tmem_load_bytes += entries * 2;
     RDP_LOG_STATE("load_tlut: sl=%u sh=%u entries=%u src=0x%06X", sl, sh, sh - sl + 1, texture_image_.addr);
     return std::max<u32>(sh - sl + 1, 8);
 }
 
-// TODO: Implement DXT row-swapping (odd rows byte-swap pairs for dual-bank TMEM interleaving)
 u32 RDP::load_block(u64 command) {
     u8 tile_index = get_bits(command, 26, 25);
     u16 number_of_texels_to_load = get_bits(command, 23, 12) + 1;
+    u16 dxt = get_bits(command, 11, 0);
 
     u32 bpp = bytes_per_pixel(texture_image_.size);
     u32 total_bytes = number_of_texels_to_load * bpp;
@@ -178,11 +260,22 @@ u32 RDP::load_block(u64 command) {
     total_bytes = std::min(total_bytes, static_cast<u32>(4096 - tiles_[tile_index].address));
 
     u32 tmem_addr = tiles_[tile_index].address;
-    for (u16 i = 0; i < total_bytes; i++) {
-        tmem_[tmem_addr + i] = rdram_.read_memory<u8>(texture_image_.addr + i);
+
+    // DXT (1.11) is added to a line counter after every 64-bit word; bit 11 of the
+    // counter selects odd lines. Load each run of words on the same line as one row.
+    u32 words = (total_bytes + 7) / 8;
+    for (u32 word = 0; word < words; ) {
+        u32 line = (word * dxt) >> 11;
+        u32 next_word = dxt ? std::min(words, ((line + 1) * 2048 + dxt - 1) / dxt) : words;
+        u32 offset = word * 8;
+        u32 length = std::min(next_word * 8, total_bytes) - offset;
+        load_tmem_row(texture_image_.addr + offset, tmem_addr + offset, length, line & 1);
+        word = next_word;
     }
-    RDP_LOG_STATE("load_block: tile=%u texels=%u bytes=%u tmem=0x%03X src=0x%06X",
-        tile_index, number_of_texels_to_load, total_bytes, tmem_addr, texture_image_.addr);
+    stats_.tmem_loads++;
+    stats_.tmem_load_bytes += total_bytes;
+    RDP_LOG_STATE("load_block: tile=%u texels=%u bytes=%u tmem=0x%03X src=0x%06X dxt=0x%03X",
+        tile_index, number_of_texels_to_load, total_bytes, tmem_addr, texture_image_.addr, dxt);
     return std::max(total_bytes, 8u);
 }
 
@@ -195,19 +288,17 @@ u32 RDP::load_tile(u64 command) {
 
     u32 bpp = bytes_per_pixel(texture_image_.size);
     u32 tmem_line_stride = tiles_[tile_index].line_bytes;
+    u32 row_bytes = (lower_right_s >= upper_left_s) ? (lower_right_s - upper_left_s + 1) * bpp : 0;
 
     u32 total_bytes = 0;
-    for (u16 t = upper_left_t; t <= lower_right_t; t++) {
-        u32 row_tmem_base = tiles_[tile_index].address + (t - upper_left_t) * tmem_line_stride;
-        for (u16 s = upper_left_s; s <= lower_right_s; s++) {
-            u32 rdram_addr = texture_image_.addr + (t * texture_image_.width + s) * bpp;
-            u32 tmem_addr = row_tmem_base + (s - upper_left_s) * bpp;
-            for (u16 i = 0; i < bpp; i++) {
-                tmem_[(tmem_addr + i) % 4096] = rdram_.read_memory<u8>(rdram_addr + i);
-            }
-            total_bytes += bpp;
-        }
+    for (u16 t = upper_left_t; t <= lower_right_t && row_bytes > 0; t++) {
+        u32 rdram_addr = texture_image_.addr + (t * texture_image_.width + upper_left_s) * bpp;
+        u32 tmem_addr = tiles_[tile_index].address + (t - upper_left_t) * tmem_line_stride;
+        load_tmem_row(rdram_addr, tmem_addr, row_bytes, (t - upper_left_t) & 1);
+        total_bytes += row_bytes;
     }
+    stats_.tmem_loads++;
+    stats_.tmem_load_bytes += total_bytes;
     RDP_LOG_STATE("load_tile: tile=%u region=(%u,%u)-(%u,%u) bytes=%u stride=%u src=0x%06X",
         tile_index, upper_left_s, upper_left_t, lower_right_s, lower_right_t,
         total_bytes, tmem_line_stride, texture_image_.addr);
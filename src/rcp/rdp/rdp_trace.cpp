@@ -0,0 +1,61 @@
+#include "rdp_trace.hpp"
+#include "rdp_registers.hpp"
+#include "../../memory/rdram.hpp"
+#include "../../memory/memory_constants.hpp"
+
+#include <cstring>
+
+namespace n64::rdp {
+
+TraceWriter::TraceWriter(const memory::RDRAM& rdram, const std::string& path)
+    : rdram_(rdram)
+    , shadow_(memory::RDRAM_MEMORY_SIZE, 0)
+{
+    file_ = std::fopen(path.c_str(), "wb");
+    if (!file_) {
+        fprintf(stderr, "[RDP] Failed to open trace file %s\n", path.c_str());
+        return;
+    }
+    u32 header[2] = {TRACE_MAGIC, TRACE_VERSION};
+    std::fwrite(header, sizeof(header), 1, file_);
+    fprintf(stderr, "[RDP] Tracing command lists to %s\n", path.c_str());
+}
+
+TraceWriter::~TraceWriter() {
+    if (file_) {
+        std::fclose(file_);
+    }
+}
+
+void TraceWriter::record_register(u32 address, u32 value) {
+    if (!file_) return;
+
+    if (address == DPC_END) {
+        record_changed_pages();
+    }
+    std::fputc(TRACE_REGISTER, file_);
+    std::fwrite(&address, sizeof(address), 1, file_);
+    std::fwrite(&value, sizeof(value), 1, file_);
+}
+
+// The RDP is the only writer while a list runs, and replay reproduces its
+// output, so the post-list state becomes the new baseline
+void TraceWriter::end_list() {
+    if (!file_) return;
+    rdram_.read_block(0, shadow_.data(), memory::RDRAM_MEMORY_SIZE);
+}
+
+void TraceWriter::record_changed_pages() {
+    u8 page[TRACE_PAGE_SIZE];
+    for (u32 address = 0; address < memory::RDRAM_MEMORY_SIZE; address += TRACE_PAGE_SIZE) {
+        rdram_.read_block(address, page, TRACE_PAGE_SIZE);
+        if (std::memcmp(page, &shadow_[address], TRACE_PAGE_SIZE) == 0) continue;
+
+        std::memcpy(&shadow_[address], page, TRACE_PAGE_SIZE);
+        std::fputc(TRACE_PAGE, file_);
+        std::fwrite(&address, sizeof(address), 1, file_);
+        std::fwrite(page, TRACE_PAGE_SIZE, 1, file_);
+    }
+}
+
+} // namespace n64::rdp
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "../../utils/types.hpp"
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace n64::memory {
+class RDRAM;
+}
+
+namespace n64::rdp {
+
+// Command-list trace file (host byte order):
+//   header:   u32 magic, u32 version
+//   register: u8 TRACE_REGISTER, u32 address, u32 value
+//   page:     u8 TRACE_PAGE, u32 address, TRACE_PAGE_SIZE bytes
+// Every DPC register write is recorded in order. Right before a DPC_END write
+// (which runs the list) each RDRAM page that changed since the previous list
+// is stored, so replaying the records on a fresh RDRAM and RDP reproduces the
+// exact input of every command list.
+constexpr u32 TRACE_MAGIC = 0x54504452;  // "RDPT"
+constexpr u32 TRACE_VERSION = 1;
+constexpr u32 TRACE_PAGE_SIZE = 4096;
+constexpr u8 TRACE_REGISTER = 1;
+constexpr u8 TRACE_PAGE = 2;
+
+class TraceWriter {
+public:
+    TraceWriter(const memory::RDRAM& rdram, const std::string& path);
+    ~TraceWriter();
+
+    TraceWriter(const TraceWriter&) = delete;
+    TraceWriter& operator=(const TraceWriter&) = delete;
+
+    [[nodiscard]] bool is_open() const { return file_ != nullptr; }
+
+    void record_register(u32 address, u32 value);
+    void end_list();
+
+private:
+    void record_changed_pages();
+
+    const memory::RDRAM& rdram_;
+    std::FILE* file_ = nullptr;
+    std::vector<u8> shadow_;
+};
+
+} // namespace n64::rdp
@@ -327,6 +327,51 @@ void RSP::on_dma_complete(u32 final_sp_addr, u32 final_rdram_addr, bool is_imem,
     current_len_ = (skip << 20) | 0xFF8;
 }
 
+void RSP::save_state(StateWriter& writer) const
+{
+    writer.begin_chunk("RSP ", 1);
+    writer.write(dmem_);
+    writer.write(imem_);
+    for (u32 i = 0; i < 32; i++) {
+        writer.write(su_.read_gpr(i));
+    }
+    vu_.save_state(writer);
+    writer.write(pending_spmem_);
+    writer.write(pending_rdram_);
+    writer.write(current_spmem_);
+    writer.write(current_rdram_);
+    writer.write(current_len_);
+    writer.write(status_);
+    writer.write(semaphore_);
+    writer.write(pc_);
+    writer.write(delay_pc_);
+    writer.write(delay_branch_pending_);
+    writer.write(rsp_cycle_accumulator_);
+    writer.end_chunk();
+}
+
+void RSP::load_state(StateReader& reader)
+{
+    if (!reader.open_chunk("RSP ", 1)) return;
+    reader.read(dmem_);
+    reader.read(imem_);
+    for (u32 i = 0; i < 32; i++) {
+        su_.write_gpr(i, reader.read<u32>());
+    }
+    vu_.load_state(reader);
+    reader.read(pending_spmem_);
+    reader.read(pending_rdram_);
+    reader.read(current_spmem_);
+    reader.read(current_rdram_);
+    reader.read(current_len_);
+    reader.read(status_);
+    reader.read(semaphore_);
+    reader.read(pc_);
+    reader.read(delay_pc_);
+    reader.read(delay_branch_pending_);
+    reader.read(rsp_cycle_accumulator_);
+}
+
 template u8 RSP::read<u8>(u32) const;
 template u16 RSP::read<u16>(u32) const;
 template u32 RSP::read<u32>(u32) const;
@@ -2,6 +2,7 @@
 
 #include <array>
 #include "../../utils/types.hpp"
+#include "../../utils/save_state.hpp"
 #include "../../interfaces/mi.hpp"
 #include "rsp_instruction.hpp"
 #include "rsp_instruction_table.hpp"
@@ -55,6 +56,11 @@ public:
     void write_imem(u32 address, u8 value) { imem_[address] = value; }
 
     void on_dma_complete(u32 final_sp_addr, u32 final_rdram_addr, bool is_imem, u32 skip);
+    void set_profiler(memory::AccessProfiler* profiler) { dma_.set_profiler(profiler); }
+
+    // DMA completes synchronously, so the registers are the whole DMA state
+    void save_state(StateWriter& writer) const;
+    void load_state(StateReader& reader);
 
 private:
 
@@ -2,6 +2,7 @@
 #include "rsp.hpp"
 #include "rsp_registers.hpp"
 #include "../../memory/rdram.hpp"
+#include "../../memory/access_profiler.hpp"
 #include <cstdio>
 
 namespace n64::rcp {
@@ -28,6 +29,11 @@ void RSPDMA::add_request(DMARequest request)
         dma_log_count++;
     }
 
+    if (profiler_) {
+        profiler_->record_dma(memory::AccessProfiler::Dma::SP, request.rdram_address, request.start_length,
+                              !request.is_read, request.count + 1, request.skip);
+    }
+
     while (request.length > 0) {
         if (request.is_read) {
             u8 data = rdram_.read_memory<u8>(request.rdram_address);
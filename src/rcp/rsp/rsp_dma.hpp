@@ -4,6 +4,7 @@
 
 namespace n64::memory {
     class RDRAM;  // Forward declaration
+    class AccessProfiler;
 }
 
 namespace n64::rcp {
@@ -38,9 +39,12 @@ public:
     void add_request(DMARequest request);
     void process_transfer(u32 cycles);
 
+    void set_profiler(memory::AccessProfiler* profiler) { profiler_ = profiler; }
+
 private:
     RSP& rsp_;
     memory::RDRAM& rdram_;
+    memory::AccessProfiler* profiler_ = nullptr;
 };
 
 } // namespace n64::rcp
\ No newline at end of file
@@ -90,4 +90,28 @@ void VU::init_square_root_table_()
     }
 }
 
+void VU::save_state(StateWriter& writer) const
+{
+    writer.write(gpr_);
+    writer.write(accumulator_);
+    writer.write(vcc_);
+    writer.write(vco_);
+    writer.write(vce_);
+    writer.write(div_in_);
+    writer.write(div_out_);
+    writer.write(div_dp_);
+}
+
+void VU::load_state(StateReader& reader)
+{
+    reader.read(gpr_);
+    reader.read(accumulator_);
+    reader.read(vcc_);
+    reader.read(vco_);
+    reader.read(vce_);
+    reader.read(div_in_);
+    reader.read(div_out_);
+    reader.read(div_dp_);
+}
+
 } // namespace n64::rcp
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../../utils/types.hpp"
+#include "../../utils/save_state.hpp"
 #include <array>
 
 namespace n64::rcp {
@@ -63,6 +64,10 @@ public:
     bool get_div_dp() const { return div_dp_; }
     void set_div_dp(bool value) { div_dp_ = value; }
 
+    // Registers, accumulator, flags and divide latches (the tables are constant)
+    void save_state(StateWriter& writer) const;
+    void load_state(StateReader& reader);
+
 private:
 
     void init_reciprocal_table_();
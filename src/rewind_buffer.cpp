@@ -0,0 +1,177 @@
+#include "rewind_buffer.hpp"
+#include "utils/save_state.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+namespace n64 {
+
+namespace {
+
+// Record layout: u32 previous state size, u32 padded state length,
+// RLE(state XOR), u32 page count, then per page u32 index + RLE(page XOR)
+void append_u32(std::vector<u8>& out, u32 value) {
+    const u8* bytes = reinterpret_cast<const u8*>(&value);
+    out.insert(out.end(), bytes, bytes + sizeof(value));
+}
+
+u32 read_u32(const u8*& in) {
+    u32 value;
+    std::memcpy(&value, in, sizeof(value));
+    in += sizeof(value);
+    return value;
+}
+
+size_t padded(size_t size) {
+    return (size + 7) & ~size_t{7};
+}
+
+void xor_into(u8* dst, const u8* src, size_t size) {
+    for (size_t i = 0; i < size; i += 8) {
+        u64 a, b;
+        std::memcpy(&a, dst + i, 8);
+        std::memcpy(&b, src + i, 8);
+        a ^= b;
+        std::memcpy(dst + i, &a, 8);
+    }
+}
+
+} // namespace
+
+RewindBuffer::RewindBuffer(memory::RDRAM& rdram, size_t arena_bytes)
+    : rdram_(rdram)
+    , arena_(arena_bytes)
+{
+    record_.reserve(1 << 20);
+}
+
+RewindBuffer::~RewindBuffer() {
+    size_t used = 0;
+    for (const Record& record : records_) used += record.size;
+    fprintf(stderr, "[REWIND] %zu snapshots held, %.1f of %.1f MB, %llu pages stored, "
+            "capture avg %.3f ms, %llu history resets\n",
+            records_.size(), used / 1048576.0, arena_.size() / 1048576.0,
+            static_cast<unsigned long long>(pages_stored_),
+            captures_ ? capture_seconds_ * 1000.0 / captures_ : 0.0,
+            static_cast<unsigned long long>(history_resets_));
+}
+
+void RewindBuffer::capture(const std::vector<u8>& state) {
+    auto start = std::chrono::steady_clock::now();
+
+    memory::RDRAM::DirtyPages dirty = rdram_.take_dirty_pages();
+    const u8* ram = rdram_.view(0, memory::RDRAM_MEMORY_SIZE);
+
+    if (!primed_) {
+        shadow_.assign(ram, ram + memory::RDRAM_MEMORY_SIZE);
+        state_ = state;
+        primed_ = true;
+        return;
+    }
+
+    // Machine state: both sides zero-padded to a common length
+    record_.clear();
+    size_t length = padded(std::max(state.size(), state_.size()));
+    append_u32(record_, static_cast<u32>(state_.size()));
+    append_u32(record_, static_cast<u32>(length));
+    state_delta_.assign(length, 0);
+    std::memcpy(state_delta_.data(), state.data(), state.size());
+    state_.resize(length, 0);
+    xor_into(state_delta_.data(), state_.data(), length);
+    rle_encode(state_delta_.data(), length, record_);
+    state_ = state;
+
+    // Pages that were written but hold the same data are skipped
+    size_t count_offset = record_.size();
+    append_u32(record_, 0);
+    u32 page_count = 0;
+    for (u32 word = 0; word < dirty.size(); word++) {
+        for (u64 bits = dirty[word]; bits != 0; bits &= bits - 1) {
+            u32 page = word * 64 + static_cast<u32>(__builtin_ctzll(bits));
+            size_t offset = static_cast<size_t>(page) * PAGE_SIZE;
+            if (std::memcmp(ram + offset, &shadow_[offset], PAGE_SIZE) == 0) continue;
+
+            std::memcpy(page_delta_.data(), ram + offset, PAGE_SIZE);
+            xor_into(page_delta_.data(), &shadow_[offset], PAGE_SIZE);
+            std::memcpy(&shadow_[offset], ram + offset, PAGE_SIZE);
+            append_u32(record_, page);
+            rle_encode(page_delta_.data(), PAGE_SIZE, record_);
+            page_count++;
+        }
+    }
+    std::memcpy(&record_[count_offset], &page_count, sizeof(page_count));
+    pages_stored_ += page_count;
+
+    store(record_);
+    captures_++;
+    capture_seconds_ += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void RewindBuffer::store(const std::vector<u8>& record) {
+    size_t size = record.size();
+    if (size > arena_.size()) {
+        // Cannot hold even this one step: the chain back is broken
+        records_.clear();
+        tail_ = 0;
+        history_resets_++;
+        return;
+    }
+
+    if (tail_ + size > arena_.size()) {
+        // Records past the tail are the oldest ones; they go with the wrap
+        while (!records_.empty() && records_.front().offset >= tail_) records_.pop_front();
+        tail_ = 0;
+    }
+    while (!records_.empty() && records_.front().offset >= tail_
+           && records_.front().offset < tail_ + size) {
+        records_.pop_front();
+    }
+
+    std::memcpy(&arena_[tail_], record.data(), size);
+    records_.push_back({tail_, size});
+    tail_ += size;
+}
+
+bool RewindBuffer::step_back(std::vector<u8>& state) {
+    if (records_.empty()) return false;
+
+    Record record = records_.back();
+    records_.pop_back();
+    tail_ = records_.empty() ? 0 : record.offset;
+
+    const u8* in = &arena_[record.offset];
+    const u8* end = in + record.size;
+
+    u32 previous_size = read_u32(in);
+    u32 length = read_u32(in);
+    state_delta_.resize(length);
+    in += rle_decode(in, end - in, state_delta_.data(), length);
+    state_.resize(length, 0);
+    xor_into(state_.data(), state_delta_.data(), length);
+    state_.resize(previous_size);
+
+    // Every page written since the newest snapshot, plus the pages the delta
+    // changes, is copied back from the shadow
+    memory::RDRAM::DirtyPages restore = rdram_.take_dirty_pages();
+    u32 page_count = read_u32(in);
+    for (u32 i = 0; i < page_count; i++) {
+        u32 page = read_u32(in);
+        in += rle_decode(in, end - in, page_delta_.data(), PAGE_SIZE);
+        xor_into(&shadow_[static_cast<size_t>(page) * PAGE_SIZE], page_delta_.data(), PAGE_SIZE);
+        restore[page / 64] |= 1ULL << (page % 64);
+    }
+    for (u32 word = 0; word < restore.size(); word++) {
+        for (u64 bits = restore[word]; bits != 0; bits &= bits - 1) {
+            u32 page = word * 64 + static_cast<u32>(__builtin_ctzll(bits));
+            u32 offset = page * PAGE_SIZE;
+            rdram_.write_block(offset, &shadow_[offset], PAGE_SIZE);
+        }
+    }
+    // RDRAM now matches the shadow again
+    (void)rdram_.take_dirty_pages();
+
+    state = state_;
+    return true;
+}
+
+} // namespace n64
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <array>
+#include <deque>
+#include <vector>
+
+#include "utils/types.hpp"
+#include "memory/rdram.hpp"
+
+namespace n64 {
+
+// Rewind history in a fixed-size arena. Each capture() stores a backward
+// delta to the previous snapshot: the XOR of old and new contents of every
+// RDRAM page written in between, and the XOR of the two serialized machine
+// states (everything except RDRAM memory), all run-length packed. A shadow
+// copy of RDRAM plus the last machine state hold the newest snapshot, and
+// step_back() applies the newest delta to them to reach the one before.
+// When the arena is full the oldest deltas are dropped.
+class RewindBuffer {
+public:
+    RewindBuffer(memory::RDRAM& rdram, size_t arena_bytes);
+    ~RewindBuffer();
+
+    RewindBuffer(const RewindBuffer&) = delete;
+    RewindBuffer& operator=(const RewindBuffer&) = delete;
+
+    // state: the machine serialized without RDRAM memory
+    void capture(const std::vector<u8>& state);
+    // Puts RDRAM back to the previous snapshot and returns that snapshot's
+    // machine state; false once the history is used up
+    bool step_back(std::vector<u8>& state);
+
+    [[nodiscard]] size_t snapshots() const { return records_.size(); }
+
+private:
+    static constexpr u32 PAGE_SIZE = memory::RDRAM::DIRTY_PAGE_SIZE;
+
+    struct Record {
+        size_t offset;
+        size_t size;
+    };
+
+    void store(const std::vector<u8>& record);
+
+    memory::RDRAM& rdram_;
+    std::vector<u8> arena_;
+    std::deque<Record> records_;  // oldest first
+    size_t tail_ = 0;
+
+    std::vector<u8> shadow_;      // RDRAM at the newest snapshot
+    std::vector<u8> state_;       // machine state at the newest snapshot
+    bool primed_ = false;
+
+    std::vector<u8> record_;
+    std::vector<u8> state_delta_;
+    std::array<u8, PAGE_SIZE> page_delta_;
+
+    u64 captures_ = 0;
+    u64 pages_stored_ = 0;
+    u64 history_resets_ = 0;
+    double capture_seconds_ = 0.0;
+};
+
+} // namespace n64
@@ -0,0 +1,256 @@
+#include "save_state.hpp"
+#include <algorithm>
+#include <cstdio>
+
+namespace n64 {
+
+namespace {
+
+// RLE record header: bit 31 set = one word repeated count times, else count
+// literal words follow
+constexpr u32 RLE_RUN = 0x80000000u;
+constexpr u32 RLE_MIN_RUN = 4;
+
+} // namespace
+
+void rle_encode(const u8* data, size_t size, std::vector<u8>& out) {
+    auto append = [&out](const void* bytes, size_t length) {
+        const u8* p = static_cast<const u8*>(bytes);
+        out.insert(out.end(), p, p + length);
+    };
+    auto word_at = [data](size_t i) {
+        u64 word;
+        std::memcpy(&word, data + i * 8, 8);
+        return word;
+    };
+
+    size_t words = size / 8;
+    size_t literal_start = 0;
+    auto flush_literals = [&](size_t end) {
+        while (literal_start < end) {
+            u32 count = static_cast<u32>(std::min<size_t>(end - literal_start, RLE_RUN - 1));
+            append(&count, sizeof(count));
+            append(data + literal_start * 8, static_cast<size_t>(count) * 8);
+            literal_start += count;
+        }
+    };
+
+    size_t i = 0;
+    while (i < words) {
+        u64 word = word_at(i);
+        size_t run = 1;
+        while (i + run < words && run < RLE_RUN - 1 && word_at(i + run) == word) run++;
+        if (run >= RLE_MIN_RUN) {
+            flush_literals(i);
+            u32 header = static_cast<u32>(run) | RLE_RUN;
+            append(&header, sizeof(header));
+            append(&word, sizeof(word));
+            literal_start = i + run;
+        }
+        i += run;
+    }
+    flush_literals(words);
+}
+
+size_t rle_decode(const u8* in, size_t in_size, u8* data, size_t size) {
+    size_t words = size / 8;
+    size_t pos = 0;
+    size_t i = 0;
+    while (i < words) {
+        u32 header;
+        if (in_size - pos < sizeof(header)) return 0;
+        std::memcpy(&header, in + pos, sizeof(header));
+        pos += sizeof(header);
+
+        u32 count = header & ~RLE_RUN;
+        if (count == 0 || count > words - i) return 0;
+        size_t payload = (header & RLE_RUN) ? 8 : static_cast<size_t>(count) * 8;
+        if (in_size - pos < payload) return 0;
+
+        if (header & RLE_RUN) {
+            for (u32 k = 0; k < count; k++) {
+                std::memcpy(data + (i + k) * 8, in + pos, 8);
+            }
+        } else {
+            std::memcpy(data + i * 8, in + pos, payload);
+        }
+        pos += payload;
+        i += count;
+    }
+    return pos;
+}
+
+StateWriter::StateWriter() {
+    buffer_.reserve(1 << 20);
+    write_bytes(STATE_MAGIC, sizeof(STATE_MAGIC));
+    write(STATE_FORMAT_VERSION);
+}
+
+void StateWriter::begin_chunk(const char (&tag)[5], u32 version) {
+    write_bytes(tag, 4);
+    write(version);
+    chunk_start_ = buffer_.size();
+    write(u32{0});  // size, patched by end_chunk
+}
+
+void StateWriter::end_chunk() {
+    u32 size = static_cast<u32>(buffer_.size() - chunk_start_ - sizeof(u32));
+    std::memcpy(&buffer_[chunk_start_], &size, sizeof(size));
+}
+
+void StateWriter::write_bytes(const void* data, size_t size) {
+    const u8* bytes = static_cast<const u8*>(data);
+    buffer_.insert(buffer_.end(), bytes, bytes + size);
+}
+
+void StateWriter::write_rle(const u8* data, size_t size) {
+    rle_encode(data, size, buffer_);
+}
+
+bool StateWriter::save(const std::string& path) const {
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        fprintf(stderr, "[STATE] Failed to open %s\n", path.c_str());
+        return false;
+    }
+    bool ok = std::fwrite(buffer_.data(), 1, buffer_.size(), file) == buffer_.size();
+    ok = std::fclose(file) == 0 && ok;
+    if (!ok) {
+        fprintf(stderr, "[STATE] Failed to write %s\n", path.c_str());
+    }
+    return ok;
+}
+
+u32 StateReader::tag_id(const char (&tag)[5]) {
+    u32 id;
+    std::memcpy(&id, tag, 4);
+    return id;
+}
+
+bool StateReader::load(const std::string& path) {
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        fprintf(stderr, "[STATE] Failed to open %s\n", path.c_str());
+        return false;
+    }
+    std::fseek(file, 0, SEEK_END);
+    long size = std::ftell(file);
+    std::fseek(file, 0, SEEK_SET);
+    buffer_.resize(size > 0 ? static_cast<size_t>(size) : 0);
+    bool read_ok = std::fread(buffer_.data(), 1, buffer_.size(), file) == buffer_.size();
+    std::fclose(file);
+
+    if (!read_ok || !index_chunks()) {
+        fprintf(stderr, "[STATE] %s is not a valid save state\n", path.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool StateReader::load(std::vector<u8> buffer) {
+    buffer_ = std::move(buffer);
+    return index_chunks();
+}
+
+bool StateReader::index_chunks() {
+    chunks_.clear();
+    ok_ = true;
+    u32 format = 0;
+    if (buffer_.size() < sizeof(STATE_MAGIC) + sizeof(u32)
+        || std::memcmp(buffer_.data(), STATE_MAGIC, sizeof(STATE_MAGIC)) != 0) {
+        return false;
+    }
+    std::memcpy(&format, &buffer_[sizeof(STATE_MAGIC)], sizeof(format));
+    if (format != STATE_FORMAT_VERSION) {
+        fprintf(stderr, "[STATE] Unsupported format version %u\n", format);
+        return false;
+    }
+
+    size_t pos = sizeof(STATE_MAGIC) + sizeof(u32);
+    while (pos + 12 <= buffer_.size()) {
+        u32 id, version, chunk_size;
+        std::memcpy(&id, &buffer_[pos], 4);
+        std::memcpy(&version, &buffer_[pos + 4], 4);
+        std::memcpy(&chunk_size, &buffer_[pos + 8], 4);
+        pos += 12;
+        if (chunk_size > buffer_.size() - pos) return false;
+        chunks_[id] = {pos, chunk_size, version};
+        pos += chunk_size;
+    }
+    return true;
+}
+
+bool StateReader::has_chunk(const char (&tag)[5]) const {
+    return chunks_.count(tag_id(tag)) != 0;
+}
+
+bool StateReader::open_chunk(const char (&tag)[5], u32 max_version) {
+    auto it = chunks_.find(tag_id(tag));
+    if (it == chunks_.end()) {
+        fprintf(stderr, "[STATE] Missing chunk '%s'\n", tag);
+        ok_ = false;
+        return false;
+    }
+    if (it->second.version > max_version) {
+        fprintf(stderr, "[STATE] Chunk '%s' version %u is newer than supported (%u)\n",
+                tag, it->second.version, max_version);
+        ok_ = false;
+        return false;
+    }
+    pos_ = it->second.offset;
+    end_ = it->second.offset + it->second.size;
+    version_ = it->second.version;
+    return true;
+}
+
+void StateReader::read_bytes(void* data, size_t size) {
+    if (!ok_ || size > end_ - pos_) {
+        pos_ = end_;
+        ok_ = false;
+        return;
+    }
+    std::memcpy(data, &buffer_[pos_], size);
+    pos_ += size;
+}
+
+void StateReader::read_rle(u8* data, size_t size) {
+    if (!ok_) return;
+    size_t used = rle_decode(&buffer_[pos_], end_ - pos_, data, size);
+    if (used == 0) {
+        ok_ = false;
+        return;
+    }
+    pos_ += used;
+}
+
+bool StateReader::check_chunk(const char (&tag)[5], const StateReader& expected) {
+    auto it = expected.chunks_.find(tag_id(tag));
+    if (it == expected.chunks_.end() || !open_chunk(tag, it->second.version)) return false;
+    if (version_ == it->second.version && end_ - pos_ != it->second.size) {
+        fprintf(stderr, "[STATE] Chunk '%s' holds %zu bytes, expected %zu\n",
+                tag, end_ - pos_, it->second.size);
+        ok_ = false;
+        return false;
+    }
+    return true;
+}
+
+void StateReader::skip_bytes(size_t size) {
+    if (!ok_ || size > end_ - pos_) {
+        pos_ = end_;
+        ok_ = false;
+        return;
+    }
+    pos_ += size;
+}
+
+void StateReader::skip_rle(size_t size) {
+    if (!ok_) return;
+    scratch_.resize(size);
+    read_rle(scratch_.data(), size);
+    if (!ok_) {
+        fprintf(stderr, "[STATE] Damaged memory image\n");
+    }
+}
+
+} // namespace n64
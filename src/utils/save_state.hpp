@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "types.hpp"
+
+namespace n64 {
+
+// Save state file layout:
+//   "N64STATE", u32 format version
+//   chunks of { char tag[4]; u32 version; u32 size; u8 data[size]; }
+// Each component writes its own chunk and checks the chunk version on load,
+// so components can extend their state independently. Fields are stored in
+// host byte order, raw, so states move between machines running the same
+// build. RAM images go through a word-based RLE (write_rle): mostly-empty
+// RDRAM shrinks to a fraction of its size at memcpy speed.
+constexpr char STATE_MAGIC[8] = {'N', '6', '4', 'S', 'T', 'A', 'T', 'E'};
+constexpr u32 STATE_FORMAT_VERSION = 1;
+
+// Word-based run-length coding (size must be a multiple of 8). rle_encode
+// appends to out; rle_decode fills data and returns the bytes of input it
+// consumed, or 0 when the input is malformed.
+void rle_encode(const u8* data, size_t size, std::vector<u8>& out);
+[[nodiscard]] size_t rle_decode(const u8* in, size_t in_size, u8* data, size_t size);
+
+class StateWriter {
+public:
+    StateWriter();
+
+    void begin_chunk(const char (&tag)[5], u32 version);
+    void end_chunk();
+
+    template<typename T>
+    void write(const T& value) {
+        static_assert(std::is_trivially_copyable_v<T>, "state fields must be plain data");
+        write_bytes(&value, sizeof(T));
+    }
+    void write_bytes(const void* data, size_t size);
+    // size must be a multiple of 8
+    void write_rle(const u8* data, size_t size);
+
+    bool save(const std::string& path) const;
+    [[nodiscard]] const std::vector<u8>& buffer() const { return buffer_; }
+    [[nodiscard]] size_t size() const { return buffer_.size(); }
+
+private:
+    std::vector<u8> buffer_;
+    size_t chunk_start_ = 0;
+};
+
+class StateReader {
+public:
+    // Reads the file and indexes its chunks
+    bool load(const std::string& path);
+    // Same, for a state serialized in memory (StateWriter::buffer)
+    bool load(std::vector<u8> buffer);
+
+    [[nodiscard]] bool has_chunk(const char (&tag)[5]) const;
+    // Positions at the chunk; fails if it is missing or newer than max_version
+    bool open_chunk(const char (&tag)[5], u32 max_version);
+    [[nodiscard]] u32 chunk_version() const { return version_; }
+
+    template<typename T>
+    void read(T& value) {
+        static_assert(std::is_trivially_copyable_v<T>, "state fields must be plain data");
+        read_bytes(&value, sizeof(T));
+    }
+    template<typename T>
+    [[nodiscard]] T read() {
+        T value{};
+        read(value);
+        return value;
+    }
+    void read_bytes(void* data, size_t size);
+    void read_rle(u8* data, size_t size);
+
+    // Checking a state before any of it is applied. check_chunk opens the
+    // chunk like open_chunk and also fails when it is the version in expected
+    // (a state written by this build) but not the same size. skip_bytes steps
+    // over fields; skip_rle decodes an image into scratch memory, failing
+    // when it is malformed.
+    bool check_chunk(const char (&tag)[5], const StateReader& expected);
+    void skip_bytes(size_t size);
+    void skip_rle(size_t size);
+    [[nodiscard]] size_t remaining() const { return end_ - pos_; }
+
+    // False once a chunk was missing or too new, a read ran past the end of
+    // its chunk or an RLE image did not decode. Reads after that leave their
+    // destinations untouched.
+    [[nodiscard]] bool ok() const { return ok_; }
+
+private:
+    struct Chunk {
+        size_t offset;
+        size_t size;
+        u32 version;
+    };
+
+    [[nodiscard]] static u32 tag_id(const char (&tag)[5]);
+    bool index_chunks();
+
+    std::vector<u8> buffer_;
+    std::unordered_map<u32, Chunk> chunks_;
+    std::vector<u8> scratch_;
+    size_t pos_ = 0;
+    size_t end_ = 0;
+    u32 version_ = 0;
+    bool ok_ = true;
+};
+
+} // namespace n64
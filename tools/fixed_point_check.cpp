@@ -0,0 +1,593 @@
+// Checks that the integer FixedPoint<> used by the rasterizer gives the same
+// results as FixedPointFloat, which it replaced in the edge walker and the
+// texture rectangle steppers.
+//
+// Three groups of randomized checks:
+//   ops       decoding, +, +=, * and >> on the command field formats
+//   triangle  the edge walker and span stepping, against the per-pixel
+//             base + slope * dx evaluation it replaced
+//   texrect   Texture_Rectangle and Texture_Rectangle_Flip S/T stepping
+//
+// FixedPointFloat keeps the integer() clamp of the value it was decoded as
+// through copies, + and +=, but a * or >> result clamps as s15. FixedPoint<>
+// keeps its format throughout, so the two only agree where such results are
+// added onto a decoded value before integer() is taken, which is the only
+// way the rasterizer uses them. The ops group checks both sides of that.
+//
+// FixedPointFloat throws on overflow where FixedPoint<> wraps; cases that
+// throw are counted and skipped.
+//
+// Usage: fixed_point_check [--seed N] [--iterations N]
+// Exits with 1 on the first mismatch.
+
+#include "rcp/rdp/fixed_point.hpp"
+#include "rcp/rdp/fixed_point_float.hpp"
+#include "rcp/rdp/rdp.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using namespace n64;
+using namespace n64::rdp;
+
+namespace {
+
+std::mt19937 rng;
+u64 skipped = 0;
+
+u32 random_bits(u32 bits) {
+    return rng() & ((1u << bits) - 1);
+}
+
+s32 random_range(s32 low, s32 high) {
+    return std::uniform_int_distribution<s32>(low, high)(rng);
+}
+
+// A field of the given width: usually a value in [low, high], sometimes any
+// bit pattern so the clamps and sign extension get exercised
+u32 random_field(u32 bits, s32 low, s32 high) {
+    if (rng() % 8 == 0) return random_bits(bits);
+    return static_cast<u32>(random_range(low, high)) & ((1u << bits) - 1);
+}
+
+bool mismatch(const char* group, u64 iteration, const char* what, s64 expected, s64 actual) {
+    fprintf(stderr, "FAIL %s #%llu: %s: FixedPointFloat %lld, FixedPoint %lld\n", group,
+            (unsigned long long)iteration, what, (long long)expected, (long long)actual);
+    return false;
+}
+
+#define CHECK(group, what, expected, actual) \
+    do { if ((expected) != (actual)) return mismatch(group, iteration, what, expected, actual); } while (0)
+
+// ===== ops =====
+
+template <u8 I, u8 F, bool S = true>
+struct Format {
+    using Fixed = FixedPoint<I, F, S>;
+    static constexpr u8 int_bits = I;
+    static constexpr u8 frac_bits = F;
+    static constexpr bool is_signed = S;
+};
+
+// FixedPointFloat's clamp after * and >>
+using S15 = FixedPoint<15, 16>;
+
+template <typename L, typename R>
+bool check_ops(u64 iteration) {
+    u32 li = random_bits(L::int_bits), lf = random_bits(L::frac_bits);
+    u32 ri = random_bits(R::int_bits), rf = random_bits(R::frac_bits);
+    FixedPointFloat lref(li, lf, L::int_bits, L::frac_bits, L::is_signed);
+    FixedPointFloat rref(ri, rf, R::int_bits, R::frac_bits, R::is_signed);
+    auto l = L::Fixed::from_fields(li, lf);
+    auto r = R::Fixed::from_fields(ri, rf);
+    s32 k = random_range(-1024, 1024);
+    int n = random_range(0, 8);
+
+    CHECK("ops", "decode raw", lref.raw(), l.raw);
+    CHECK("ops", "decode integer", lref.integer(), l.integer());
+    CHECK("ops", "decode frac", lref.frac(), l.frac());
+
+    try {
+        // + and += keep the left operand's clamp
+        FixedPointFloat sum_ref = lref + rref;
+        auto sum = l + r;
+        CHECK("ops", "+ raw", sum_ref.raw(), sum.raw);
+        CHECK("ops", "+ integer", sum_ref.integer(), sum.integer());
+
+        FixedPointFloat acc_ref = lref;
+        acc_ref += rref;
+        auto acc = l;
+        acc += r;
+        acc_ref += rref;
+        acc += r;
+        CHECK("ops", "+= raw", acc_ref.raw(), acc.raw);
+        CHECK("ops", "+= integer", acc_ref.integer(), acc.integer());
+
+        // * and >> results: same bits, but FixedPointFloat clamps them as s15
+        FixedPointFloat product_ref = rref * k;
+        auto product = r * k;
+        CHECK("ops", "* raw", product_ref.raw(), product.raw);
+        CHECK("ops", "* integer (s15)", product_ref.integer(), S15::from_raw(product.raw).integer());
+
+        FixedPointFloat shifted_ref = rref >> n;
+        auto shifted = r >> n;
+        CHECK("ops", ">> raw", shifted_ref.raw(), shifted.raw);
+        CHECK("ops", ">> integer (s15)", shifted_ref.integer(), S15::from_raw(shifted.raw).integer());
+
+        // As the rasterizer uses them: added onto a decoded value first
+        FixedPointFloat stepped_ref = lref + rref * k;
+        auto stepped = l + r * k;
+        CHECK("ops", "base + d * k raw", stepped_ref.raw(), stepped.raw);
+        CHECK("ops", "base + d * k integer", stepped_ref.integer(), stepped.integer());
+
+        FixedPointFloat scaled_ref = lref;
+        scaled_ref += rref >> n;
+        auto scaled = l;
+        scaled += r >> n;
+        CHECK("ops", "base += d >> n raw", scaled_ref.raw(), scaled.raw);
+        CHECK("ops", "base += d >> n integer", scaled_ref.integer(), scaled.integer());
+    } catch (const std::overflow_error&) {
+        skipped++;
+    }
+    return true;
+}
+
+using EdgeYFormat     = Format<12, 2>;
+using EdgeXFormat     = Format<12, 16>;
+using EdgeSlopeFormat = Format<14, 16>;
+using AttributeFormat = Format<16, 16>;
+using TexCoordFormat  = Format<11, 5>;
+using TexSlopeFormat  = Format<6, 10>;
+using RectFormat      = Format<10, 2, false>;
+
+static_assert(std::is_same_v<EdgeYFormat::Fixed, EdgeY>);
+static_assert(std::is_same_v<EdgeXFormat::Fixed, EdgeX>);
+static_assert(std::is_same_v<EdgeSlopeFormat::Fixed, EdgeSlope>);
+static_assert(std::is_same_v<AttributeFormat::Fixed, Attribute>);
+static_assert(std::is_same_v<TexCoordFormat::Fixed, TexCoord>);
+static_assert(std::is_same_v<TexSlopeFormat::Fixed, TexSlope>);
+
+bool check_ops(u64 iteration) {
+    return check_ops<EdgeXFormat, EdgeSlopeFormat>(iteration)
+        && check_ops<AttributeFormat, AttributeFormat>(iteration)
+        && check_ops<TexCoordFormat, TexSlopeFormat>(iteration)
+        && check_ops<EdgeYFormat, EdgeYFormat>(iteration)
+        && check_ops<EdgeSlopeFormat, EdgeXFormat>(iteration)
+        && check_ops<TexSlopeFormat, TexCoordFormat>(iteration)
+        && check_ops<RectFormat, RectFormat>(iteration);
+}
+
+// ===== triangle =====
+
+struct Field {
+    u32 int_part;
+    u32 frac_part;
+};
+
+struct Triangle {
+    bool l_major;
+    u8 cycle_type;
+    Field y_low, y_mid, y_high;
+    Field x_low, dx_low_dy, x_high, dx_high_dy, x_mid, dx_mid_dy;
+    // r, g, b, a, s, t, z; each as value, DxDx, DxDe (DxDy is not walked)
+    Field attributes[7][3];
+    std::optional<u64> scissor;  // Set_Scissor command, or the power-on scissor
+};
+
+Triangle random_triangle() {
+    Triangle tri{};
+    tri.l_major = rng() & 1;
+    tri.cycle_type = rng() & 3;
+
+    s32 top = random_range(-16, 240);
+    s32 mid = top + random_range(0, 64);
+    s32 bottom = mid + random_range(0, 64);
+    tri.y_high = {random_field(12, top, top), random_bits(2)};
+    tri.y_mid = {random_field(12, mid, mid), random_bits(2)};
+    tri.y_low = {random_field(12, bottom, bottom), random_bits(2)};
+
+    Field* edges[] = {&tri.x_low, &tri.x_high, &tri.x_mid};
+    Field* slopes[] = {&tri.dx_low_dy, &tri.dx_high_dy, &tri.dx_mid_dy};
+    for (int i = 0; i < 3; i++) {
+        *edges[i] = {random_field(12, -32, 352), random_bits(16)};
+        *slopes[i] = {random_field(14, -8, 8), random_bits(16)};
+    }
+    if (rng() % 8 == 0) tri.dx_high_dy = {0, 0};
+
+    for (auto& attribute : tri.attributes) {
+        attribute[0] = {random_field(16, -64, 0x7FFF), random_bits(16)};
+        attribute[1] = {random_field(16, -4, 4), random_bits(16)};
+        attribute[2] = {random_field(16, -4, 4), random_bits(16)};
+        // Zero DsDx/DtDx selects the DxDe offset path
+        if (rng() % 8 == 0) attribute[1] = {0, 0};
+    }
+
+    if (rng() % 16 != 0) {
+        u64 left = random_range(0, 64 * 4), top_edge = random_range(0, 64 * 4);
+        u64 right = left + random_range(0, 320 * 4), bottom_edge = top_edge + random_range(0, 240 * 4);
+        tri.scissor = (left & 0xFFF) << 44 | (top_edge & 0xFFF) << 32 | (right & 0xFFF) << 12 | (bottom_edge & 0xFFF);
+    }
+    return tri;
+}
+
+template <typename T>
+u8 pixel_cvg(s32 x, const T& x_left, const T& x_right) {
+    if (x == x_left.integer()) {
+        return 7 - (x_left.frac() >> 13);
+    } else if (x == x_right.integer() - 1) {
+        u8 frac = x_right.frac() >> 13;
+        return frac ? frac : 7;
+    }
+    return 7;
+}
+
+// The walker before FixedPoint<>: every attribute evaluated per pixel
+std::optional<std::vector<s32>> reference_triangle(const Triangle& tri) {
+    std::vector<s32> out;
+    Scissor scissor = tri.scissor ? Scissor(*tri.scissor) : Scissor();
+    auto decode = [](Field f, u8 int_size, u8 frac_size) {
+        return FixedPointFloat(f.int_part, f.frac_part, int_size, frac_size, true);
+    };
+    try {
+        FixedPointFloat y_low = decode(tri.y_low, 12, 2);
+        FixedPointFloat y_mid = decode(tri.y_mid, 12, 2);
+        FixedPointFloat y_high = decode(tri.y_high, 12, 2);
+        FixedPointFloat x_low = decode(tri.x_low, 12, 16);
+        FixedPointFloat dx_low_dy = decode(tri.dx_low_dy, 14, 16);
+        FixedPointFloat x_high = decode(tri.x_high, 12, 16);
+        FixedPointFloat dx_high_dy = decode(tri.dx_high_dy, 14, 16);
+        FixedPointFloat x_mid = decode(tri.x_mid, 12, 16);
+        FixedPointFloat dx_mid_dy = decode(tri.dx_mid_dy, 14, 16);
+
+        FixedPointFloat value[7], dxdx[7], dxde[7];
+        for (int i = 0; i < 7; i++) {
+            value[i] = decode(tri.attributes[i][0], 16, 16);
+            dxdx[i] = decode(tri.attributes[i][1], 16, 16);
+            dxde[i] = decode(tri.attributes[i][2], 16, 16);
+        }
+        FixedPointFloat &r = value[0], &g = value[1], &b = value[2], &a = value[3];
+        FixedPointFloat &s = value[4], &t = value[5], &z = value[6];
+        const FixedPointFloat &DsDx = dxdx[4], &DtDx = dxdx[5];
+        const FixedPointFloat &DsDe = dxde[4], &DtDe = dxde[5];
+        u8 cycle_type = tri.cycle_type;
+
+        s32 y_start = std::max(y_high, scissor.scissor_rect.top).integer();
+        s32 y_end = std::min(y_low, scissor.scissor_rect.bottom).integer();
+
+        for (s32 y = y_start; y < y_end; y++) {
+            FixedPointFloat x_left;
+            FixedPointFloat x_right;
+
+            if (tri.l_major) {
+                x_left = x_high;
+                x_right = (y < y_mid.integer()) ? x_mid : x_low;
+            } else {
+                x_left = (y < y_mid.integer()) ? x_mid : x_low;
+                x_right = x_high;
+            }
+
+            s32 x_start = std::max(x_left.integer(), scissor.scissor_rect.left.integer());
+            s32 x_end = std::min(x_right.integer(), scissor.scissor_rect.right.integer());
+            if (cycle_type > 1) x_end++;
+            out.insert(out.end(), {y, x_start, x_end});
+
+            s32 major_x = x_high.integer();
+            FixedPointFloat eff_DsDx = (cycle_type == 2) ? (DsDx >> 2) : DsDx;
+            FixedPointFloat eff_DtDx = (cycle_type == 2) ? (DtDx >> 2) : DtDx;
+            bool do_offset = (dx_high_dy.raw() != 0) && (cycle_type <= 1);
+            FixedPointFloat dsdiff = (do_offset && DsDx.raw() == 0) ? DsDe : FixedPointFloat();
+            FixedPointFloat dtdiff = (do_offset && DtDx.raw() == 0) ? DtDe : FixedPointFloat();
+
+            for (s32 x = x_start; x < x_end; x++) {
+                s64 dx = x - major_x;
+                out.push_back((s + dsdiff + eff_DsDx * dx).integer() >> 5);
+                out.push_back((t + dtdiff + eff_DtDx * dx).integer() >> 5);
+                out.push_back(std::clamp((r + dxdx[0] * dx).integer(), 0, 255));
+                out.push_back(std::clamp((g + dxdx[1] * dx).integer(), 0, 255));
+                out.push_back(std::clamp((b + dxdx[2] * dx).integer(), 0, 255));
+                out.push_back(std::clamp((a + dxdx[3] * dx).integer(), 0, 255));
+                out.push_back(std::clamp((z + dxdx[6] * dx).integer(), 0, 0x7FFF));
+                out.push_back(pixel_cvg(x, x_left, x_right));
+            }
+
+            x_high += dx_high_dy;
+            if (y < y_mid.integer()) {
+                x_mid += dx_mid_dy;
+            } else {
+                x_low += dx_low_dy;
+            }
+            for (int i = 0; i < 7; i++) value[i] += dxde[i];
+        }
+    } catch (const std::overflow_error&) {
+        return std::nullopt;
+    }
+    return out;
+}
+
+// The walker in rdp_rasterizer.cpp: attributes evaluated once at x_start and
+// stepped by DxDx
+std::vector<s32> current_triangle(const Triangle& tri) {
+    std::vector<s32> out;
+    Scissor scissor = tri.scissor ? Scissor(*tri.scissor) : Scissor();
+    auto y_low = EdgeY::from_fields(tri.y_low.int_part, tri.y_low.frac_part);
+    auto y_mid = EdgeY::from_fields(tri.y_mid.int_part, tri.y_mid.frac_part);
+    auto y_high = EdgeY::from_fields(tri.y_high.int_part, tri.y_high.frac_part);
+    auto x_low = EdgeX::from_fields(tri.x_low.int_part, tri.x_low.frac_part);
+    auto dx_low_dy = EdgeSlope::from_fields(tri.dx_low_dy.int_part, tri.dx_low_dy.frac_part);
+    auto x_high = EdgeX::from_fields(tri.x_high.int_part, tri.x_high.frac_part);
+    auto dx_high_dy = EdgeSlope::from_fields(tri.dx_high_dy.int_part, tri.dx_high_dy.frac_part);
+    auto x_mid = EdgeX::from_fields(tri.x_mid.int_part, tri.x_mid.frac_part);
+    auto dx_mid_dy = EdgeSlope::from_fields(tri.dx_mid_dy.int_part, tri.dx_mid_dy.frac_part);
+
+    Attribute value[7], dxdx[7], dxde[7];
+    for (int i = 0; i < 7; i++) {
+        value[i] = Attribute::from_fields(tri.attributes[i][0].int_part, tri.attributes[i][0].frac_part);
+        dxdx[i] = Attribute::from_fields(tri.attributes[i][1].int_part, tri.attributes[i][1].frac_part);
+        dxde[i] = Attribute::from_fields(tri.attributes[i][2].int_part, tri.attributes[i][2].frac_part);
+    }
+    Attribute &r = value[0], &g = value[1], &b = value[2], &a = value[3];
+    Attribute &s = value[4], &t = value[5], &z = value[6];
+    const Attribute &DsDx = dxdx[4], &DtDx = dxdx[5];
+    const Attribute &DsDe = dxde[4], &DtDe = dxde[5];
+    u8 cycle_type = tri.cycle_type;
+
+    s32 y_start = std::max(y_high.integer(), scissor.scissor_rect.top.integer());
+    s32 y_end = std::min(y_low.integer(), scissor.scissor_rect.bottom.integer());
+    s32 y_mid_int = y_mid.integer();
+    s32 scissor_left = scissor.scissor_rect.left.integer();
+    s32 scissor_right = scissor.scissor_rect.right.integer();
+
+    Attribute eff_DsDx = (cycle_type == 2) ? (DsDx >> 2) : DsDx;
+    Attribute eff_DtDx = (cycle_type == 2) ? (DtDx >> 2) : DtDx;
+    bool do_offset = (dx_high_dy.raw != 0) && (cycle_type <= 1);
+    Attribute dsdiff = (do_offset && DsDx.raw == 0) ? DsDe : Attribute{};
+    Attribute dtdiff = (do_offset && DtDx.raw == 0) ? DtDe : Attribute{};
+
+    for (s32 y = y_start; y < y_end; y++) {
+        EdgeX x_left;
+        EdgeX x_right;
+
+        if (tri.l_major) {
+            x_left = x_high;
+            x_right = (y < y_mid_int) ? x_mid : x_low;
+        } else {
+            x_left = (y < y_mid_int) ? x_mid : x_low;
+            x_right = x_high;
+        }
+
+        s32 x_start = std::max(x_left.integer(), scissor_left);
+        s32 x_end = std::min(x_right.integer(), scissor_right);
+        if (cycle_type > 1) x_end++;
+        out.insert(out.end(), {y, x_start, x_end});
+
+        s32 dx = x_start - x_high.integer();
+        Attribute z_x = z + dxdx[6] * dx;
+        Attribute s_x = s + dsdiff + eff_DsDx * dx;
+        Attribute t_x = t + dtdiff + eff_DtDx * dx;
+        Attribute r_x = r + dxdx[0] * dx;
+        Attribute g_x = g + dxdx[1] * dx;
+        Attribute b_x = b + dxdx[2] * dx;
+        Attribute a_x = a + dxdx[3] * dx;
+
+        for (s32 x = x_start; x < x_end; x++) {
+            out.push_back(s_x.integer() >> 5);
+            out.push_back(t_x.integer() >> 5);
+            out.push_back(std::clamp(r_x.integer(), 0, 255));
+            out.push_back(std::clamp(g_x.integer(), 0, 255));
+            out.push_back(std::clamp(b_x.integer(), 0, 255));
+            out.push_back(std::clamp(a_x.integer(), 0, 255));
+            out.push_back(std::clamp(z_x.integer(), 0, 0x7FFF));
+            out.push_back(pixel_cvg(x, x_left, x_right));
+
+            s_x += eff_DsDx;
+            t_x += eff_DtDx;
+            r_x += dxdx[0];
+            g_x += dxdx[1];
+            b_x += dxdx[2];
+            a_x += dxdx[3];
+            z_x += dxdx[6];
+        }
+
+        x_high += dx_high_dy;
+        if (y < y_mid_int) {
+            x_mid += dx_mid_dy;
+        } else {
+            x_low += dx_low_dy;
+        }
+        for (int i = 0; i < 7; i++) value[i] += dxde[i];
+    }
+    return out;
+}
+
+bool compare_streams(const char* group, u64 iteration, const std::vector<s32>& expected,
+                     const std::vector<s32>& actual) {
+    size_t common = std::min(expected.size(), actual.size());
+    for (size_t i = 0; i < common; i++) {
+        if (expected[i] != actual[i]) {
+            fprintf(stderr, "FAIL %s #%llu: value %zu: FixedPointFloat %d, FixedPoint %d\n", group,
+                    (unsigned long long)iteration, i, expected[i], actual[i]);
+            return false;
+        }
+    }
+    if (expected.size() != actual.size()) {
+        fprintf(stderr, "FAIL %s #%llu: %zu values from FixedPointFloat, %zu from FixedPoint\n", group,
+                (unsigned long long)iteration, expected.size(), actual.size());
+        return false;
+    }
+    return true;
+}
+
+bool check_triangle(u64 iteration, u64& values) {
+    Triangle tri = random_triangle();
+    auto expected = reference_triangle(tri);
+    if (!expected) {
+        skipped++;
+        return true;
+    }
+    values += expected->size();
+    return compare_streams("triangle", iteration, *expected, current_triangle(tri));
+}
+
+// ===== texrect =====
+
+struct TexRect {
+    u64 command;     // rectangle and tile
+    Field s, t, dsdx, dtdy;
+    u8 cycle_type;
+    bool flip;
+    std::optional<u64> scissor;
+};
+
+TexRect random_texrect() {
+    TexRect rect{};
+    u64 left = random_range(0, 320 * 4), top = random_range(0, 240 * 4);
+    u64 right = left + random_range(0, 64 * 4), bottom = top + random_range(0, 64 * 4);
+    rect.command = (std::min<u64>(right, 0xFFF) << 44) | (std::min<u64>(bottom, 0xFFF) << 32)
+                 | (left << 12) | top;
+    rect.s = {random_field(11, -64, 1023), random_bits(5)};
+    rect.t = {random_field(11, -64, 1023), random_bits(5)};
+    rect.dsdx = {random_field(6, -4, 4), random_bits(10)};
+    rect.dtdy = {random_field(6, -4, 4), random_bits(10)};
+    rect.cycle_type = rng() & 3;
+    rect.flip = rng() & 1;
+    if (rng() % 4 != 0) {
+        rect.scissor = (u64)random_range(0, 32 * 4) << 44 | (u64)random_range(0, 32 * 4) << 32
+                     | (u64)random_range(160 * 4, 1023 * 4) << 12 | (u64)random_range(120 * 4, 1023 * 4);
+    }
+    return rect;
+}
+
+// Before FixedPoint<>: FixedPointFloat accumulators and u16 loop counters
+std::vector<s32> reference_texrect(const TexRect& tr) {
+    std::vector<s32> out;
+    Scissor scissor = tr.scissor ? Scissor(*tr.scissor) : Scissor();
+    Rectangle rect(tr.command);
+    scissor.clip(rect);
+    if (!tr.flip && tr.cycle_type > 1) {
+        rect.bottom++;
+        rect.right++;
+    }
+    FixedPointFloat s(tr.s.int_part, tr.s.frac_part, 11, 5, true);
+    FixedPointFloat t(tr.t.int_part, tr.t.frac_part, 11, 5, true);
+    FixedPointFloat dsdx(tr.dsdx.int_part, tr.dsdx.frac_part, 6, 10, true);
+    FixedPointFloat dtdy(tr.dtdy.int_part, tr.dtdy.frac_part, 6, 10, true);
+    FixedPointFloat s_inc = (tr.cycle_type == 2) ? (dsdx >> 2) : dsdx;
+
+    if (!tr.flip) {
+        FixedPointFloat t_acc = t;
+        for (u16 y = rect.top.integer(); y < rect.bottom.integer(); y++) {
+            FixedPointFloat s_acc = s;
+            s32 tex_t = t_acc.integer();
+            for (u16 x = rect.left.integer(); x < rect.right.integer(); x++) {
+                s32 tex_s = s_acc.integer();
+                s_acc += s_inc;
+                out.insert(out.end(), {x, y, tex_s, tex_t});
+            }
+            t_acc += dtdy;
+        }
+    } else {
+        FixedPointFloat s_acc = s;
+        for (u16 y = rect.top.integer(); y < rect.bottom.integer(); y++) {
+            FixedPointFloat t_acc = t;
+            s32 tex_s = s_acc.integer();
+            for (u16 x = rect.left.integer(); x < rect.right.integer(); x++) {
+                s32 tex_t = t_acc.integer();
+                t_acc += dtdy;
+                out.insert(out.end(), {x, y, tex_s, tex_t});
+            }
+            s_acc += s_inc;
+        }
+    }
+    return out;
+}
+
+std::vector<s32> current_texrect(const TexRect& tr) {
+    std::vector<s32> out;
+    Scissor scissor = tr.scissor ? Scissor(*tr.scissor) : Scissor();
+    Rectangle rect(tr.command);
+    scissor.clip(rect);
+    if (!tr.flip && tr.cycle_type > 1) {
+        rect.bottom++;
+        rect.right++;
+    }
+    auto s = TexCoord::from_fields(tr.s.int_part, tr.s.frac_part);
+    auto t = TexCoord::from_fields(tr.t.int_part, tr.t.frac_part);
+    auto dsdx = TexSlope::from_fields(tr.dsdx.int_part, tr.dsdx.frac_part);
+    auto dtdy = TexSlope::from_fields(tr.dtdy.int_part, tr.dtdy.frac_part);
+    TexSlope s_inc = (tr.cycle_type == 2) ? (dsdx >> 2) : dsdx;
+
+    s32 left = rect.left.integer();
+    s32 right = rect.right.integer();
+    s32 bottom = rect.bottom.integer();
+    if (!tr.flip) {
+        TexCoord t_acc = t;
+        for (s32 y = rect.top.integer(); y < bottom; y++) {
+            TexCoord s_acc = s;
+            s32 tex_t = t_acc.integer();
+            for (s32 x = left; x < right; x++) {
+                s32 tex_s = s_acc.integer();
+                s_acc += s_inc;
+                out.insert(out.end(), {x, y, tex_s, tex_t});
+            }
+            t_acc += dtdy;
+        }
+    } else {
+        TexCoord s_acc = s;
+        for (s32 y = rect.top.integer(); y < bottom; y++) {
+            TexCoord t_acc = t;
+            s32 tex_s = s_acc.integer();
+            for (s32 x = left; x < right; x++) {
+                s32 tex_t = t_acc.integer();
+                t_acc += dtdy;
+                out.insert(out.end(), {x, y, tex_s, tex_t});
+            }
+            s_acc += s_inc;
+        }
+    }
+    return out;
+}
+
+bool check_texrect(u64 iteration, u64& values) {
+    TexRect rect = random_texrect();
+    std::vector<s32> expected = reference_texrect(rect);
+    values += expected.size();
+    return compare_streams("texrect", iteration, expected, current_texrect(rect));
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    u32 seed = 1;
+    u64 iterations = 20000;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = static_cast<u32>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (std::strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+            iterations = std::strtoull(argv[++i], nullptr, 10);
+        } else {
+            fprintf(stderr, "Usage: %s [--seed N] [--iterations N]\n", argv[0]);
+            return 2;
+        }
+    }
+    rng.seed(seed);
+
+    u64 triangle_values = 0;
+    u64 texrect_values = 0;
+    for (u64 i = 0; i < iterations; i++) {
+        if (!check_ops(i)) return 1;
+        if (!check_triangle(i, triangle_values)) return 1;
+        if (!check_texrect(i, texrect_values)) return 1;
+    }
+
+    printf("PASS seed %u: %llu iterations, %llu triangle and %llu texrect values compared, "
+           "%llu overflowing cases skipped\n",
+           seed, (unsigned long long)iterations, (unsigned long long)triangle_values,
+           (unsigned long long)texrect_values, (unsigned long long)skipped);
+    return 0;
+}
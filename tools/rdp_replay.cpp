@@ -0,0 +1,161 @@
+// Replays an RDP command-list trace (recorded with RDP_TRACE=<file>, format in
+// src/rcp/rdp/rdp_trace.hpp) against a fresh RDRAM and RDP with no CPU or RSP
+// involved, and reports rasterizer throughput and RDRAM hashes.
+//
+// Usage: rdp_replay <trace> [--repeat N] [--hashes] [--stats <csv>]
+
+#include "rcp/rdp/rdp.hpp"
+#include "rcp/rdp/rdp_registers.hpp"
+#include "rcp/rdp/rdp_trace.hpp"
+#include "memory/rdram.hpp"
+#include "memory/memory_constants.hpp"
+#include "interfaces/mi.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+using namespace n64;
+
+namespace {
+
+struct Record {
+    u8 type;
+    u32 address;
+    u32 value;        // register value
+    size_t page;      // offset into the page pool
+};
+
+bool load_trace(const char* path, std::vector<Record>& records, std::vector<u8>& pages) {
+    std::FILE* file = std::fopen(path, "rb");
+    if (!file) {
+        fprintf(stderr, "Failed to open %s\n", path);
+        return false;
+    }
+
+    u32 header[2];
+    if (std::fread(header, sizeof(header), 1, file) != 1 || header[0] != rdp::TRACE_MAGIC) {
+        fprintf(stderr, "%s is not an RDP trace\n", path);
+        std::fclose(file);
+        return false;
+    }
+    if (header[1] != rdp::TRACE_VERSION) {
+        fprintf(stderr, "Unsupported trace version %u\n", header[1]);
+        std::fclose(file);
+        return false;
+    }
+
+    int type;
+    while ((type = std::fgetc(file)) != EOF) {
+        Record record{static_cast<u8>(type), 0, 0, 0};
+        bool ok = std::fread(&record.address, sizeof(record.address), 1, file) == 1;
+        if (type == rdp::TRACE_REGISTER) {
+            ok = ok && std::fread(&record.value, sizeof(record.value), 1, file) == 1;
+        } else if (type == rdp::TRACE_PAGE) {
+            record.page = pages.size();
+            pages.resize(pages.size() + rdp::TRACE_PAGE_SIZE);
+            ok = ok && std::fread(&pages[record.page], rdp::TRACE_PAGE_SIZE, 1, file) == 1;
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            fprintf(stderr, "Truncated or corrupt trace after %zu records\n", records.size());
+            break;
+        }
+        records.push_back(record);
+    }
+    std::fclose(file);
+    return true;
+}
+
+// FNV-1a over the whole of RDRAM
+u64 hash_rdram(const memory::RDRAM& rdram) {
+    std::vector<u8> data(memory::RDRAM_MEMORY_SIZE);
+    rdram.read_block(0, data.data(), memory::RDRAM_MEMORY_SIZE);
+    u64 hash = 0xCBF29CE484222325ULL;
+    for (u8 byte : data) {
+        hash = (hash ^ byte) * 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <trace> [--repeat N] [--hashes] [--stats <csv>]\n", argv[0]);
+        return 1;
+    }
+
+    int repeat = 1;
+    bool list_hashes = false;
+    const char* stats_path = nullptr;
+    for (int i = 2; i < argc; i++) {
+        if (std::strcmp(argv[i], "--repeat") == 0 && i + 1 < argc) {
+            repeat = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--hashes") == 0) {
+            list_hashes = true;
+        } else if (std::strcmp(argv[i], "--stats") == 0 && i + 1 < argc) {
+            stats_path = argv[++i];
+        } else {
+            fprintf(stderr, "Unknown option %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    std::vector<Record> records;
+    std::vector<u8> pages;
+    if (!load_trace(argv[1], records, pages)) return 1;
+
+    double best_seconds = 0.0;
+    u64 pixels = 0;
+    u32 lists = 0;
+    u64 final_hash = 0;
+
+    for (int run = 0; run < repeat; run++) {
+        auto rdram = std::make_unique<memory::RDRAM>();
+        interfaces::MI mi;
+        auto rdp = std::make_unique<rdp::RDP>(*rdram, mi);
+        if (stats_path && run == 0) {
+            rdp->start_stats_log(stats_path);
+        }
+        std::srand(0);  // noise dither
+
+        double seconds = 0.0;
+        lists = 0;
+        for (const Record& record : records) {
+            if (record.type == rdp::TRACE_PAGE) {
+                rdram->write_block(record.address, &pages[record.page], rdp::TRACE_PAGE_SIZE);
+                continue;
+            }
+            if (record.address != rdp::DPC_END) {
+                rdp->write_register(record.address, record.value);
+                continue;
+            }
+
+            auto start = std::chrono::steady_clock::now();
+            rdp->write_register(record.address, record.value);
+            seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            if (list_hashes && run == 0) {
+                printf("list %u: %016llx\n", lists, static_cast<unsigned long long>(hash_rdram(*rdram)));
+            }
+            lists++;
+        }
+
+        if (run == 0 || seconds < best_seconds) best_seconds = seconds;
+        pixels = rdp->pixels_drawn();
+        final_hash = hash_rdram(*rdram);
+    }
+
+    printf("lists:      %u\n", lists);
+    printf("pixels:     %llu\n", static_cast<unsigned long long>(pixels));
+    printf("time:       %.3f ms (best of %d)\n", best_seconds * 1000.0, repeat);
+    printf("throughput: %.2f Mpixels/s\n", best_seconds > 0.0 ? pixels / best_seconds / 1e6 : 0.0);
+    printf("rdram hash: %016llx\n", static_cast<unsigned long long>(final_hash));
+    return 0;
+}